@@ -0,0 +1,97 @@
+#ifndef BINARYIO_H
+#define BINARYIO_H
+
+#include "DataSource.h"
+#include "DataSink.h"
+#include <vector>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+#include <algorithm>
+
+// Helpers for saving plain values and arrays of them in the byte order of this machine.
+// Values are appended to a buffer that is written to a sink in one go, and read back
+// from a source in the same order.
+namespace BinaryIO{
+
+template <typename TValue>
+void Append(std::vector<char> &buf, const TValue &value){
+    static_assert(std::is_trivially_copyable<TValue>::value, "only plain values can be saved");
+    auto Bytes = reinterpret_cast<const char *>(&value);
+    buf.insert(buf.end(), Bytes, Bytes + sizeof(TValue));
+}
+
+// Saves the element count followed by the elements
+template <typename TValue>
+void AppendVector(std::vector<char> &buf, const std::vector<TValue> &values){
+    static_assert(std::is_trivially_copyable<TValue>::value, "only plain values can be saved");
+    Append(buf, uint64_t(values.size()));
+    auto Bytes = reinterpret_cast<const char *>(values.data());
+    buf.insert(buf.end(), Bytes, Bytes + values.size() * sizeof(TValue));
+}
+
+// Reads exactly count bytes, false if the source ends first
+inline bool ReadBytes(CDataSource &source, void *dest, std::size_t count){
+    std::vector<char> Buffer;
+    auto Bytes = static_cast<char *>(dest);
+    while(count){
+        if(!source.Read(Buffer, count)){
+            return false;
+        }
+        std::memcpy(Bytes, Buffer.data(), Buffer.size());
+        Bytes += Buffer.size();
+        count -= Buffer.size();
+    }
+    return true;
+}
+
+template <typename TValue>
+bool Read(CDataSource &source, TValue &value){
+    static_assert(std::is_trivially_copyable<TValue>::value, "only plain values can be loaded");
+    return ReadBytes(source, &value, sizeof(TValue));
+}
+
+// Reads a vector saved by AppendVector, false if it ends early or holds more than maxcount elements.
+// It grows as the elements arrive, so a damaged count cannot allocate more than the source holds.
+template <typename TValue>
+bool ReadVector(CDataSource &source, std::vector<TValue> &values, uint64_t maxcount){
+    const uint64_t ChunkCount = 65536;
+    uint64_t Count;
+    if(!Read(source, Count) || Count > maxcount){
+        return false;
+    }
+    values.clear();
+    while(values.size() < Count){
+        auto Start = values.size();
+        values.resize(Start + std::min(ChunkCount, Count - Start));
+        if(!ReadBytes(source, values.data() + Start, (values.size() - Start) * sizeof(TValue))){
+            return false;
+        }
+    }
+    return true;
+}
+
+// FNV-1a hash, seed chains the hash of several pieces together
+inline uint64_t Hash(const void *data, std::size_t size, uint64_t seed = 14695981039346656037ULL){
+    auto Bytes = static_cast<const unsigned char *>(data);
+    for(std::size_t Index = 0; Index < size; Index++){
+        seed = (seed ^ Bytes[Index]) * 1099511628211ULL;
+    }
+    return seed;
+}
+
+// Continues a hash over everything left in a source, followed by its length so that one
+// source's bytes cannot pass for the start of the next
+inline uint64_t HashSource(CDataSource &source, uint64_t seed = 14695981039346656037ULL){
+    std::vector<char> Buffer;
+    uint64_t Size = 0;
+    while(source.Read(Buffer, 65536)){
+        seed = Hash(Buffer.data(), Buffer.size(), seed);
+        Size += Buffer.size();
+    }
+    return Hash(&Size, sizeof(Size), seed);
+}
+
+}
+
+#endif
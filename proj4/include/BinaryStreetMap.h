@@ -0,0 +1,49 @@
+#ifndef BINARYSTREETMAP_H
+#define BINARYSTREETMAP_H
+
+#include "StreetMap.h"
+#include "BusSystem.h"
+#include "DataSource.h"
+#include "DataSink.h"
+#include <memory>
+#include <string>
+#include <vector>
+
+// Street map read from a file compiled by mapcompile. The file is memory mapped and
+// nodes, ways and their attributes are read straight out of the mapping, so loading
+// costs no parsing and processes that open the same file share its pages. The bus
+// system compiled into the same file is available through BusSystem().
+class CBinaryStreetMap : public CStreetMap{
+    private:
+        struct SImplementation;
+        std::shared_ptr<SImplementation> DImplementation;
+
+    public:
+        // Format version written by Write, files with any other version are not loaded
+        static const uint32_t FormatVersion = 2;
+
+        // Only loads a file written with the same sourcehash, so a file compiled from older
+        // sources is never used in place of the current ones
+        CBinaryStreetMap(const std::string &filename, uint64_t sourcehash);
+        ~CBinaryStreetMap();
+
+        // True when the file was mapped, has the expected format and was compiled from the
+        // sources given by the hash, otherwise the map is empty
+        bool Loaded() const noexcept;
+        std::shared_ptr<CBusSystem> BusSystem() const noexcept;
+
+        // Hash of the contents of the files a map is compiled from, it reads the sources to their end
+        static uint64_t SourceHash(const std::vector<std::shared_ptr<CDataSource>> &sources);
+        // Writes the street map and bus system in the format read by the constructor, marked
+        // with the SourceHash of the files they were read from
+        static bool Write(const CStreetMap &streetmap, const CBusSystem &bussystem, uint64_t sourcehash, std::shared_ptr<CDataSink> sink);
+
+        std::size_t NodeCount() const noexcept override;
+        std::size_t WayCount() const noexcept override;
+        std::shared_ptr<CStreetMap::SNode> NodeByIndex(std::size_t index) const noexcept override;
+        std::shared_ptr<CStreetMap::SNode> NodeByID(TNodeID id) const noexcept override;
+        std::shared_ptr<CStreetMap::SWay> WayByIndex(std::size_t index) const noexcept override;
+        std::shared_ptr<CStreetMap::SWay> WayByID(TWayID id) const noexcept override;
+};
+
+#endif
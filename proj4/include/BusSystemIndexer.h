@@ -1,7 +1,11 @@
 #ifndef BUSSYSTEMINDEXER_H
 #define BUSSYSTEMINDEXER_H
 #include "BusSystem.h"
+#include "DSVReader.h"
+#include <unordered_map>
 #include <unordered_set>
+#include <utility>
+#include <vector>
 
 class CBusSystemIndexer{
     private:
@@ -11,7 +15,25 @@ class CBusSystemIndexer{
         using TNodeID = CStreetMap::TNodeID;
         using SStop = CBusSystem::SStop;
         using SRoute = CBusSystem::SRoute;
+        // Street nodes a bus follows from the stop at DSource to the next stop at DDestination
+        struct SSegmentPath{
+            TNodeID DSource;
+            TNodeID DDestination;
+            std::vector<TNodeID> DNodeIDs;
+        };
+        // Hash of a (source, destination) node pair, mixes the second ID so that (a, b) and (b, a) land in different buckets
+        struct SNodePairHash{
+            std::size_t operator()(const std::pair<TNodeID, TNodeID> &pair) const noexcept{
+                return std::hash<TNodeID>()(pair.first) ^ (std::hash<TNodeID>()(pair.second) * 0x9E3779B97F4A7C15ULL);
+            }
+        };
+
         CBusSystemIndexer(std::shared_ptr<CBusSystem> bussystem);
+        // Also reads stop to stop street paths with src_id, dest_id and path columns like buspaths.csv.
+        // Paths are kept for consecutive stops of a route whose nodes are all in the street map.
+        // Stops the bus system moved to another node (such as onto a way) map their node in buspaths
+        // to the new one in movednodes, their paths then start or end at the new node.
+        CBusSystemIndexer(std::shared_ptr<CBusSystem> bussystem, std::shared_ptr<CDSVReader> buspaths, std::shared_ptr<CStreetMap> streetmap, const std::unordered_map<TNodeID, TNodeID> &movednodes = {});
         ~CBusSystemIndexer();
 
         std::size_t StopCount() const noexcept;
@@ -19,8 +41,13 @@ class CBusSystemIndexer{
         std::shared_ptr<SStop> SortedStopByIndex(std::size_t index) const noexcept;
         std::shared_ptr<SRoute> SortedRouteByIndex(std::size_t index) const noexcept;
         std::shared_ptr<SStop> StopByNodeID(TNodeID id) const noexcept;
+        // Routes that stop at the src node and next at the dest node, found in constant time
         bool RoutesByNodeIDs(TNodeID src, TNodeID dest, std::unordered_set<std::shared_ptr<SRoute> > &routes) const noexcept;
         bool RouteBetweenNodeIDs(TNodeID src, TNodeID dest) const noexcept;
+        // Segment paths sorted by source and destination node
+        std::size_t SegmentPathCount() const noexcept;
+        std::shared_ptr<SSegmentPath> SegmentPathByIndex(std::size_t index) const noexcept;
+        std::shared_ptr<SSegmentPath> SegmentPathByNodeIDs(TNodeID src, TNodeID dest) const noexcept;
 };
 
 #endif
@@ -0,0 +1,46 @@
+#ifndef CONTRACTIONHIERARCHYPATHROUTER_H
+#define CONTRACTIONHIERARCHYPATHROUTER_H
+
+#include "PathRouter.h"
+#include "DataSource.h"
+#include "DataSink.h"
+#include <memory>
+
+// Path router that uses Precompute to contract the graph into a contraction hierarchy.
+// Queries run a bidirectional upward search and unpack shortcuts into the original
+// vertices. Until the hierarchy is complete (no Precompute yet, the deadline passed,
+// or the graph changed afterwards) queries fall back to bidirectional Dijkstra.
+// Contraction is done in small steps, a Precompute that runs out of time leaves its
+// progress for the next call to continue from.
+class CContractionHierarchyPathRouter : public CPathRouter{
+    private:
+        struct SImplementation;
+        std::unique_ptr<SImplementation> DImplementation;
+    public:
+        CContractionHierarchyPathRouter();
+        ~CContractionHierarchyPathRouter();
+
+        std::size_t VertexCount() const noexcept;
+        TVertexID AddVertex(std::any tag) noexcept;
+        std::any GetVertexTag(TVertexID id) const noexcept;
+        bool AddEdge(TVertexID src, TVertexID dest, double weight, bool bidir = false) noexcept;
+        bool Precompute(std::chrono::steady_clock::time_point deadline) noexcept;
+        double FindShortestPath(TVertexID src, TVertexID dest, std::vector<TVertexID> &path) noexcept;
+        // Distances from every source to every destination, distances[i][j] is from srcs[i] to dests[j]
+        // or NoPathExists. With the hierarchy this takes one upward search per source and per
+        // destination (bucket based many-to-many), without it one Dijkstra search per source.
+        // Sums of hierarchy edges can differ from FindShortestPath in the last bits.
+        void FindDistances(const std::vector<TVertexID> &srcs, const std::vector<TVertexID> &dests, std::vector<std::vector<double>> &distances) noexcept;
+
+        // True once Precompute has finished contracting the current graph
+        bool Contracted() const noexcept;
+        // Fraction of the contraction done, a Precompute that ran out of time is resumed by the next one
+        double PrecomputeProgress() const noexcept;
+        // Writes the finished hierarchy, false if Precompute has not finished
+        bool SaveHierarchy(std::shared_ptr<CDataSink> sink) const noexcept;
+        // Reads a hierarchy written by SaveHierarchy for this same graph in place of Precompute,
+        // false (and the router unchanged) if it was saved for a different graph or is damaged
+        bool LoadHierarchy(std::shared_ptr<CDataSource> source) noexcept;
+};
+
+#endif
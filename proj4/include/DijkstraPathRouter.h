@@ -3,12 +3,16 @@
 
 #include "PathRouter.h"
 #include <memory>
+#include <functional>
 
 class CDijkstraPathRouter : public CPathRouter{
     private:
         struct SImplementation;
         std::unique_ptr<SImplementation> DImplementation;
     public:
+        // Lower bound on the remaining cost from vertex to dest, must never overestimate
+        using THeuristic = std::function<double(TVertexID vertex, TVertexID dest)>;
+
         CDijkstraPathRouter();
         ~CDijkstraPathRouter();
 
@@ -17,7 +21,22 @@ class CDijkstraPathRouter : public CPathRouter{
         std::any GetVertexTag(TVertexID id) const noexcept;
         bool AddEdge(TVertexID src, TVertexID dest, double weight, bool bidir = false) noexcept;
         bool Precompute(std::chrono::steady_clock::time_point deadline) noexcept;
+        // Fraction of the precompute work done for the current graph, a later Precompute resumes the rest
+        double PrecomputeProgress() const noexcept;
         double FindShortestPath(TVertexID src, TVertexID dest, std::vector<TVertexID> &path) noexcept;
+        // Distances from every source to every destination, distances[i][j] is from srcs[i] to dests[j]
+        // or NoPathExists. Runs one plain Dijkstra per source that ends once all dests are settled.
+        void FindDistances(const std::vector<TVertexID> &srcs, const std::vector<TVertexID> &dests, std::vector<std::vector<double>> &distances) noexcept;
+
+        // Switches queries to A* with the given heuristic, an empty heuristic restores plain Dijkstra
+        void SetHeuristic(THeuristic heuristic) noexcept;
+        // Searches from both ends over the forward and reverse adjacency, the heuristic is not used in this mode
+        void SetBidirectional(bool bidirectional) noexcept;
+        // Has Precompute pick this many ALT landmarks and store distances to and from each of them.
+        // Queries then add the triangle inequality bound to the A* heuristic until the graph changes.
+        void SetLandmarkCount(std::size_t count) noexcept;
+        // Landmarks whose distance tables are ready, in the order they were picked
+        std::vector<TVertexID> Landmarks() const noexcept;
 };
 
 #endif
@@ -2,6 +2,9 @@
 #define DIJKSTRATRANSPORTATIONPLANNER_H
 
 #include "TransportationPlanner.h"
+#include "DataSource.h"
+#include "DataSink.h"
+#include "DSVReader.h"
 
 class CDijkstraTransportationPlanner : public CTransportationPlanner{
     private:
@@ -9,6 +12,10 @@ class CDijkstraTransportationPlanner : public CTransportationPlanner{
         std::unique_ptr<SImplementation> DImplementation;
     public:
         CDijkstraTransportationPlanner(std::shared_ptr<SConfiguration> config);
+        // Starts from artifacts saved by SaveArtifacts instead of precomputing, when they were
+        // saved for the same map, bus system, bus paths and configuration. With buspaths (see
+        // CBusSystemIndexer) buses ride straight from stop to stop along the loaded paths.
+        CDijkstraTransportationPlanner(std::shared_ptr<SConfiguration> config, std::shared_ptr<CDataSource> artifacts, std::shared_ptr<CDSVReader> buspaths = nullptr);
         ~CDijkstraTransportationPlanner();
 
         std::size_t NodeCount() const noexcept override;
@@ -17,6 +24,31 @@ class CDijkstraTransportationPlanner : public CTransportationPlanner{
         double FindShortestPath(TNodeID src, TNodeID dest, std::vector< TNodeID > &path) override;
         double FindFastestPath(TNodeID src, TNodeID dest, std::vector< TTripStep > &path) override;
         bool GetPathDescription(const std::vector< TTripStep > &path, std::vector< std::string > &desc) const override;
+
+        // Far cheaper than a query per pair, the searches from all sources and targets share their
+        // work through the routing hierarchy
+        std::vector< std::vector< double > > FindDistanceMatrix(const std::vector< TNodeID > &sources, const std::vector< TNodeID > &targets, EDistanceMode mode) override;
+
+        // Node on a way nearest to the location, so trips can start and end at any coordinates.
+        // Stops of the bus system on nodes off every way are placed on their nearest such node.
+        TNodeID FindNearestNode(CStreetMap::TLocation location) const noexcept;
+        // Up to count nodes on ways ordered from nearest to farthest
+        std::vector< TNodeID > FindNearestNodes(CStreetMap::TLocation location, std::size_t count) const;
+
+        // Writes the precomputed routing data, false until precomputation has finished
+        bool SaveArtifacts(std::shared_ptr<CDataSink> sink) const;
+        // True if the artifacts given to the constructor were used
+        bool ArtifactsLoaded() const noexcept;
+
+        // Reads a bus timetable in the format of CRaptorTransitRouter for FindScheduledPath, stops
+        // are placed through the bus system. Trips are dropped unless the bus system has their
+        // route stop at each of their next stops. False if the timetable has no usable trips.
+        bool LoadSchedule(std::shared_ptr<CDSVReader> stoptimes);
+        // Earliest arrival leaving src at departure (hours past midnight) by walking and riding the
+        // scheduled trips, walking the whole way if that is no slower. Returns the hours until
+        // arrival including the wait for each bus. The steps are like those of FindFastestPath, one
+        // bus step per stop, and GetPathDescription describes them.
+        double FindScheduledPath(TNodeID src, TNodeID dest, double departure, std::vector<TTripStep> &path);
 };
 
 #endif
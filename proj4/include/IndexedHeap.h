@@ -0,0 +1,142 @@
+#ifndef INDEXEDHEAP_H
+#define INDEXEDHEAP_H
+
+#include <vector>
+#include <limits>
+#include <cstddef>
+#include <utility>
+
+// Min d-ary heap over dense item IDs (0..N-1) with decrease-key.
+// Item positions are tracked in a flat array, so Update() on an item already
+// in the heap moves it in place instead of pushing a duplicate. Clear() only
+// touches the items still in the heap, so a heap that is reused across
+// searches costs nothing proportional to N after the first Resize().
+template <std::size_t Arity = 4>
+class CIndexedHeap{
+    public:
+        using TItem = std::size_t;
+
+        static constexpr std::size_t NotInHeap = std::numeric_limits<std::size_t>::max();
+
+    private:
+        std::vector<std::pair<double, TItem>> DEntries;
+        std::vector<std::size_t> DPositions;
+
+        void Place(std::size_t position, const std::pair<double, TItem> &entry){
+            DEntries[position] = entry;
+            DPositions[entry.second] = position;
+        }
+
+        void SiftUp(std::size_t position){
+            auto Entry = DEntries[position];
+            while(position > 0){
+                auto Parent = (position - 1) / Arity;
+                if(!(Entry.first < DEntries[Parent].first)){
+                    break;
+                }
+                Place(position, DEntries[Parent]);
+                position = Parent;
+            }
+            Place(position, Entry);
+        }
+
+        void SiftDown(std::size_t position){
+            auto Entry = DEntries[position];
+            auto Count = DEntries.size();
+            while(true){
+                auto FirstChild = position * Arity + 1;
+                if(FirstChild >= Count){
+                    break;
+                }
+                auto LastChild = FirstChild + Arity < Count ? FirstChild + Arity : Count;
+                auto BestChild = FirstChild;
+                for(auto Child = FirstChild + 1; Child < LastChild; Child++){
+                    if(DEntries[Child].first < DEntries[BestChild].first){
+                        BestChild = Child;
+                    }
+                }
+                if(!(DEntries[BestChild].first < Entry.first)){
+                    break;
+                }
+                Place(position, DEntries[BestChild]);
+                position = BestChild;
+            }
+            Place(position, Entry);
+        }
+
+    public:
+        // Grows the position table so items 0..count-1 can be stored
+        void Resize(std::size_t count){
+            if(DPositions.size() < count){
+                DPositions.resize(count, NotInHeap);
+            }
+        }
+
+        bool Empty() const noexcept{
+            return DEntries.empty();
+        }
+
+        std::size_t Size() const noexcept{
+            return DEntries.size();
+        }
+
+        bool Contains(TItem item) const noexcept{
+            return item < DPositions.size() && DPositions[item] != NotInHeap;
+        }
+
+        TItem TopItem() const noexcept{
+            return DEntries.front().second;
+        }
+
+        double TopKey() const noexcept{
+            return DEntries.front().first;
+        }
+
+        // Inserts the item, or lowers its key if it is already queued with a larger one
+        void Update(TItem item, double key){
+            auto Position = DPositions[item];
+            if(Position == NotInHeap){
+                DEntries.push_back(std::make_pair(key, item));
+                SiftUp(DEntries.size() - 1);
+            }
+            else if(key < DEntries[Position].first){
+                DEntries[Position].first = key;
+                SiftUp(Position);
+            }
+        }
+
+        // Sets the item's key whether it is larger or smaller than before, inserting it if needed
+        void Assign(TItem item, double key){
+            auto Position = DPositions[item];
+            if(Position == NotInHeap){
+                Update(item, key);
+            }
+            else if(key < DEntries[Position].first){
+                DEntries[Position].first = key;
+                SiftUp(Position);
+            }
+            else{
+                DEntries[Position].first = key;
+                SiftDown(Position);
+            }
+        }
+
+        void Pop(){
+            DPositions[DEntries.front().second] = NotInHeap;
+            auto Last = DEntries.back();
+            DEntries.pop_back();
+            if(!DEntries.empty()){
+                DEntries.front() = Last;
+                SiftDown(0);
+            }
+        }
+
+        void Clear(){
+            for(auto &Entry : DEntries){
+                DPositions[Entry.second] = NotInHeap;
+            }
+            DEntries.clear();
+        }
+};
+
+#endif
@@ -11,6 +11,9 @@ class COpenStreetMap : public CStreetMap{
 
     public:
         COpenStreetMap(std::shared_ptr<CXMLReader> src);
+        // Loads the document straight from the source without building XML entities, much faster for large maps.
+        // Throws std::runtime_error if the document is malformed or an id, lat, lon or ref is not a number.
+        COpenStreetMap(std::shared_ptr<CDataSource> src);
         ~COpenStreetMap();
 
         std::size_t NodeCount() const noexcept override;
@@ -0,0 +1,55 @@
+#ifndef PATHSEARCHWORKSPACE_H
+#define PATHSEARCHWORKSPACE_H
+
+#include "PathRouter.h"
+#include "IndexedHeap.h"
+#include <vector>
+#include <cstdint>
+#include <algorithm>
+
+// Dense per-vertex search state that path routers reuse across queries. Entries are only
+// valid when their stamp matches the current search, so starting a new search is O(1)
+// instead of O(N).
+struct SPathSearchWorkspace{
+    using TVertexID = CPathRouter::TVertexID;
+
+    std::vector<double> Dist;
+    std::vector<TVertexID> ParentVertex; // Parent vertex helps reconstruct the path
+    std::vector<double> Estimate; // Heuristic value, computed once when a vertex is first reached
+    std::vector<uint32_t> Stamps;
+    uint32_t CurrentStamp = 0;
+    CIndexedHeap<4> Heap;
+
+    void Reset(std::size_t vertexCount){
+        if(Stamps.size() < vertexCount){
+            Dist.resize(vertexCount);
+            ParentVertex.resize(vertexCount);
+            Estimate.resize(vertexCount);
+            Stamps.resize(vertexCount, 0);
+            Heap.Resize(vertexCount);
+        }
+        Heap.Clear();
+        CurrentStamp++;
+        // On wrap around, old stamps could look current again so wipe them all
+        if(CurrentStamp == 0){
+            std::fill(Stamps.begin(), Stamps.end(), 0);
+            CurrentStamp = 1;
+        }
+    }
+
+    bool Reached(TVertexID vertex) const{
+        return Stamps[vertex] == CurrentStamp;
+    }
+
+    double Distance(TVertexID vertex) const{
+        return Reached(vertex) ? Dist[vertex] : std::numeric_limits<double>::infinity();
+    }
+
+    void Relax(TVertexID vertex, double dist, TVertexID parent){
+        Dist[vertex] = dist;
+        ParentVertex[vertex] = parent;
+        Stamps[vertex] = CurrentStamp;
+    }
+};
+
+#endif
@@ -0,0 +1,67 @@
+#ifndef RAPTORTRANSITROUTER_H
+#define RAPTORTRANSITROUTER_H
+
+#include "BusSystem.h"
+#include "DSVReader.h"
+#include <memory>
+#include <functional>
+#include <vector>
+#include <string>
+#include <limits>
+
+// Timetable router over scheduled bus trips using RAPTOR (round based public transit routing).
+// Round k finds the earliest arrival at every stop with k trips, scanning each route pattern
+// touched by the previous round once in stop order instead of searching a time expanded graph.
+// The schedule is read from rows of route,trip,stop_id,time where the rows of a trip list its
+// stops in order and time is H:MM[:SS] past midnight (hours may exceed 23 for trips after
+// midnight). Rows that do not parse, such as a header, are skipped.
+class CRaptorTransitRouter{
+    private:
+        struct SImplementation;
+        std::unique_ptr<SImplementation> DImplementation;
+    public:
+        using TStopID = CBusSystem::TStopID;
+        // Seconds past midnight of the service day
+        using TTime = int64_t;
+
+        static constexpr TTime NoArrival = std::numeric_limits<TTime>::max();
+
+        // One part of a journey, either a ride on a trip or a walk between two stops
+        struct SLeg{
+            bool DWalk;
+            std::string DRoute;
+            std::string DTrip;
+            // Stops passed from boarding to alighting, or the two ends of a walk
+            std::vector<TStopID> DStops;
+            TTime DDeparture;
+            TTime DArrival;
+        };
+
+        // Whether a trip of the route may ride from the stop src straight to the stop dest
+        using THopFilter = std::function<bool(const std::string &route, TStopID src, TStopID dest)>;
+
+        // Trips with a ride between consecutive stops that hopfilter rejects are dropped
+        CRaptorTransitRouter(std::shared_ptr<CDSVReader> stoptimes, THopFilter hopfilter = nullptr);
+        ~CRaptorTransitRouter();
+
+        std::size_t StopCount() const noexcept;
+        std::size_t TripCount() const noexcept;
+        // Trips with the same stops are grouped into patterns that never overtake each other
+        std::size_t PatternCount() const noexcept;
+        // Stop IDs served by the schedule in ascending order
+        std::vector<TStopID> Stops() const;
+
+        // Adds a walk between two scheduled stops that transfers can use, false if either has no trips
+        bool AddTransfer(TStopID src, TStopID dest, TTime duration) noexcept;
+
+        // Earliest arrival at the destination for a traveler leaving at departure. Access holds the
+        // stops reachable from the origin with their walking times, egress the stops the destination
+        // can be walked to from. Journey gets the legs between the first and last stop, at most
+        // maxtrips rides. Returns NoArrival if no trips get there.
+        TTime FindEarliestArrival(const std::vector<std::pair<TStopID, TTime>> &access, const std::vector<std::pair<TStopID, TTime>> &egress, TTime departure, std::vector<SLeg> &journey, std::size_t maxtrips = 5) const;
+
+        // Parses H:MM or H:MM:SS, false if the text is not a time
+        static bool ParseTime(const std::string &str, TTime &time) noexcept;
+};
+
+#endif
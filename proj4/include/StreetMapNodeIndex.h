@@ -0,0 +1,33 @@
+#ifndef STREETMAPNODEINDEX_H
+#define STREETMAPNODEINDEX_H
+
+#include "StreetMap.h"
+#include <memory>
+#include <vector>
+
+// Spatial index over the node locations of a street map for nearest node queries. Nodes are
+// bucketed into a uniform grid of roughly square cells sized for a few nodes each, and a query
+// searches rings of cells outward until no closer node can remain. Distances are measured in a
+// local flat projection, which is accurate at city scale.
+class CStreetMapNodeIndex{
+    private:
+        struct SImplementation;
+        std::unique_ptr<SImplementation> DImplementation;
+    public:
+        using TNodeID = CStreetMap::TNodeID;
+        using TLocation = CStreetMap::TLocation;
+
+        // With routableonly only nodes on a way are indexed, others are never a nearest node
+        CStreetMapNodeIndex(std::shared_ptr<CStreetMap> streetmap, bool routableonly = true);
+        ~CStreetMapNodeIndex();
+
+        std::size_t NodeCount() const noexcept;
+        // True if the node is indexed, so with routableonly if it is on a way
+        bool Contains(TNodeID id) const noexcept;
+        // InvalidNodeID if the index is empty
+        TNodeID NearestNode(TLocation location) const noexcept;
+        // Up to count nodes ordered from nearest to farthest
+        std::vector<TNodeID> NearestNodes(TLocation location, std::size_t count) const;
+};
+
+#endif
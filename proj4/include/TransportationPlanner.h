@@ -10,6 +10,8 @@ class CTransportationPlanner{
         using TNodeID = CStreetMap::TNodeID;
         enum class ETransportationMode {Walk, Bike, Bus};
         using TTripStep = std::pair<ETransportationMode, TNodeID>;
+        // Which query a distance matrix answers for every pair
+        enum class EDistanceMode {Shortest, Fastest};
 
         struct SConfiguration{
             virtual ~SConfiguration(){};
@@ -30,6 +32,21 @@ class CTransportationPlanner{
         virtual double FindShortestPath(TNodeID src, TNodeID dest, std::vector< TNodeID > &path) = 0;
         virtual double FindFastestPath(TNodeID src, TNodeID dest, std::vector< TTripStep > &path) = 0;
         virtual bool GetPathDescription(const std::vector< TTripStep > &path, std::vector< std::string > &desc) const = 0;
+
+        // Dense table of what FindShortestPath (miles) or FindFastestPath (hours) returns for every
+        // pair, matrix[i][j] is from sources[i] to targets[j]. Runs one query per pair, planners
+        // that can share work between the queries override it.
+        virtual std::vector< std::vector< double > > FindDistanceMatrix(const std::vector< TNodeID > &sources, const std::vector< TNodeID > &targets, EDistanceMode mode){
+            std::vector< std::vector< double > > Matrix(sources.size(), std::vector< double >(targets.size()));
+            std::vector< TNodeID > ShortestPath;
+            std::vector< TTripStep > FastestPath;
+            for(std::size_t Row = 0; Row < sources.size(); Row++){
+                for(std::size_t Column = 0; Column < targets.size(); Column++){
+                    Matrix[Row][Column] = mode == EDistanceMode::Shortest ? FindShortestPath(sources[Row], targets[Column], ShortestPath) : FindFastestPath(sources[Row], targets[Column], FastestPath);
+                }
+            }
+            return Matrix;
+        }
 };
 
 #endif
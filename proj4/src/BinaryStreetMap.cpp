@@ -0,0 +1,578 @@
+#include "BinaryStreetMap.h"
+#include "BinaryIO.h"
+#include <vector>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <algorithm>
+#include <numeric>
+#include <cstring>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+// The file is a header followed by flat arrays (sections), each starting on an 8 byte
+// boundary. Numbers are stored in the byte order of the machine that wrote the file.
+// Nodes and ways are stored by column in the order the source map lists them, the
+// Order sections hold their indexes sorted by ID for binary search. Attribute keys,
+// values and route names are indexes into one table of distinct strings. The header also
+// holds the SourceHash of the files the map was compiled from.
+struct CBinaryStreetMap::SImplementation {
+    enum ESection : uint32_t {
+        NodeIDs,                // TNodeID per node
+        NodeLatitudes,          // double per node
+        NodeLongitudes,         // double per node
+        NodeOrder,              // uint32_t node indexes sorted by ID
+        NodeAttributeOffsets,   // uint64_t per node plus one, range of the node's Attributes
+        WayIDs,                 // TWayID per way
+        WayOrder,               // uint32_t way indexes sorted by ID
+        WayNodeOffsets,         // uint64_t per way plus one, range of the way's WayNodeIDs
+        WayNodeIDs,             // TNodeID per node of each way
+        WayAttributeOffsets,    // uint64_t per way plus one, range of the way's Attributes
+        Attributes,             // SAttribute
+        StringOffsets,          // uint64_t per string plus one, range of the string's StringData
+        StringData,             // char
+        StopIDs,                // TStopID per stop
+        StopNodeIDs,            // TNodeID per stop
+        StopOrder,              // uint32_t stop indexes sorted by ID
+        RouteNames,             // uint32_t string per route
+        RouteStopOffsets,       // uint64_t per route plus one, range of the route's RouteStopIDs
+        RouteStopIDs,           // TStopID per stop of each route
+        SectionCount
+    };
+
+    struct SSection {
+        uint64_t Offset;
+        uint64_t Count;
+    };
+
+    struct SHeader {
+        char Magic[8];
+        uint32_t Version;
+        uint32_t SectionCount;
+        uint64_t SourceHash;
+        SSection Sections[ESection::SectionCount];
+    };
+
+    struct SAttribute {
+        uint32_t Key;
+        uint32_t Value;
+    };
+
+    static constexpr char Magic[8] = {'S','T','R','E','E','T','M','P'};
+
+    static std::size_t ElementSize(ESection section) {
+        switch (section) {
+            case NodeLatitudes:
+            case NodeLongitudes:        return sizeof(double);
+            case NodeOrder:
+            case WayOrder:
+            case StopOrder:
+            case RouteNames:            return sizeof(uint32_t);
+            case Attributes:            return sizeof(SAttribute);
+            case StringData:            return sizeof(char);
+            default:                    return sizeof(uint64_t);
+        }
+    }
+
+    struct SNodeView : public CStreetMap::SNode {
+        std::shared_ptr<const SImplementation> Map;
+        std::size_t Index;
+
+        SNodeView(std::shared_ptr<const SImplementation> map, std::size_t index) : Map(std::move(map)), Index(index) {}
+
+        TNodeID ID() const noexcept override {
+            return Map->Section<TNodeID>(NodeIDs)[Index];
+        }
+
+        TLocation Location() const noexcept override {
+            return std::make_pair(Map->Section<double>(NodeLatitudes)[Index], Map->Section<double>(NodeLongitudes)[Index]);
+        }
+
+        std::size_t AttributeCount() const noexcept override {
+            return Map->AttributeCount(NodeAttributeOffsets, Index);
+        }
+
+        std::string GetAttributeKey(std::size_t index) const noexcept override {
+            return Map->AttributeKey(NodeAttributeOffsets, Index, index);
+        }
+
+        bool HasAttribute(const std::string &key) const noexcept override {
+            return Map->FindAttribute(NodeAttributeOffsets, Index, key) != nullptr;
+        }
+
+        std::string GetAttribute(const std::string &key) const noexcept override {
+            auto Attribute = Map->FindAttribute(NodeAttributeOffsets, Index, key);
+            return Attribute ? std::string(Map->String(Attribute->Value)) : "";
+        }
+    };
+
+    struct SWayView : public CStreetMap::SWay {
+        std::shared_ptr<const SImplementation> Map;
+        std::size_t Index;
+
+        SWayView(std::shared_ptr<const SImplementation> map, std::size_t index) : Map(std::move(map)), Index(index) {}
+
+        TWayID ID() const noexcept override {
+            return Map->Section<TWayID>(WayIDs)[Index];
+        }
+
+        std::size_t NodeCount() const noexcept override {
+            auto Offsets = Map->Section<uint64_t>(WayNodeOffsets);
+            return Offsets[Index + 1] - Offsets[Index];
+        }
+
+        TNodeID GetNodeID(std::size_t index) const noexcept override {
+            if (index >= NodeCount()) {
+                return CStreetMap::InvalidNodeID;
+            }
+            return Map->Section<TNodeID>(WayNodeIDs)[Map->Section<uint64_t>(WayNodeOffsets)[Index] + index];
+        }
+
+        std::size_t AttributeCount() const noexcept override {
+            return Map->AttributeCount(WayAttributeOffsets, Index);
+        }
+
+        std::string GetAttributeKey(std::size_t index) const noexcept override {
+            return Map->AttributeKey(WayAttributeOffsets, Index, index);
+        }
+
+        bool HasAttribute(const std::string &key) const noexcept override {
+            return Map->FindAttribute(WayAttributeOffsets, Index, key) != nullptr;
+        }
+
+        std::string GetAttribute(const std::string &key) const noexcept override {
+            auto Attribute = Map->FindAttribute(WayAttributeOffsets, Index, key);
+            return Attribute ? std::string(Map->String(Attribute->Value)) : "";
+        }
+    };
+
+    struct SStopView : public CBusSystem::SStop {
+        std::shared_ptr<const SImplementation> Map;
+        std::size_t Index;
+
+        SStopView(std::shared_ptr<const SImplementation> map, std::size_t index) : Map(std::move(map)), Index(index) {}
+
+        CBusSystem::TStopID ID() const noexcept override {
+            return Map->Section<CBusSystem::TStopID>(StopIDs)[Index];
+        }
+
+        CStreetMap::TNodeID NodeID() const noexcept override {
+            return Map->Section<CStreetMap::TNodeID>(StopNodeIDs)[Index];
+        }
+    };
+
+    struct SRouteView : public CBusSystem::SRoute {
+        std::shared_ptr<const SImplementation> Map;
+        std::size_t Index;
+
+        SRouteView(std::shared_ptr<const SImplementation> map, std::size_t index) : Map(std::move(map)), Index(index) {}
+
+        std::string Name() const noexcept override {
+            return std::string(Map->String(Map->Section<uint32_t>(RouteNames)[Index]));
+        }
+
+        std::size_t StopCount() const noexcept override {
+            auto Offsets = Map->Section<uint64_t>(RouteStopOffsets);
+            return Offsets[Index + 1] - Offsets[Index];
+        }
+
+        CBusSystem::TStopID GetStopID(std::size_t index) const noexcept override {
+            if (index >= StopCount()) {
+                return CBusSystem::InvalidStopID;
+            }
+            return Map->Section<CBusSystem::TStopID>(RouteStopIDs)[Map->Section<uint64_t>(RouteStopOffsets)[Index] + index];
+        }
+    };
+
+    // Bus system half of the file, it shares ownership of the mapping like the views do
+    struct SBusSystem : public CBusSystem {
+        std::shared_ptr<const SImplementation> Map;
+
+        SBusSystem(std::shared_ptr<const SImplementation> map) : Map(std::move(map)) {}
+
+        std::size_t StopCount() const noexcept override {
+            return Map->Count(StopIDs);
+        }
+
+        std::size_t RouteCount() const noexcept override {
+            return Map->Count(RouteNames);
+        }
+
+        std::shared_ptr<SStop> StopByIndex(std::size_t index) const noexcept override {
+            if (index >= StopCount()) {
+                return nullptr;
+            }
+            return std::make_shared<SStopView>(Map, index);
+        }
+
+        std::shared_ptr<SStop> StopByID(TStopID id) const noexcept override {
+            auto Index = Map->FindByID(StopIDs, StopOrder, id);
+            if (Index == NotFound) {
+                return nullptr;
+            }
+            return std::make_shared<SStopView>(Map, Index);
+        }
+
+        std::shared_ptr<SRoute> RouteByIndex(std::size_t index) const noexcept override {
+            if (index >= RouteCount()) {
+                return nullptr;
+            }
+            return std::make_shared<SRouteView>(Map, index);
+        }
+
+        std::shared_ptr<SRoute> RouteByName(const std::string &name) const noexcept override {
+            auto Names = Map->Section<uint32_t>(RouteNames);
+            for (std::size_t Index = 0; Index < RouteCount(); Index++) {
+                if (Map->String(Names[Index]) == name) {
+                    return std::make_shared<SRouteView>(Map, Index);
+                }
+            }
+            return nullptr;
+        }
+    };
+
+    static constexpr std::size_t NotFound = std::numeric_limits<std::size_t>::max();
+
+    void *DMapping = nullptr;
+    std::size_t DSize = 0;
+    const SHeader *DHeader = nullptr;
+
+    SImplementation(const std::string &filename, uint64_t sourcehash) {
+        int FileDescriptor = open(filename.c_str(), O_RDONLY);
+        if (FileDescriptor < 0) {
+            return;
+        }
+        struct stat FileStatus;
+        if (fstat(FileDescriptor, &FileStatus) == 0 && FileStatus.st_size >= static_cast<off_t>(sizeof(SHeader))) {
+            auto Mapping = mmap(nullptr, FileStatus.st_size, PROT_READ, MAP_SHARED, FileDescriptor, 0);
+            if (Mapping != MAP_FAILED) {
+                DMapping = Mapping;
+                DSize = FileStatus.st_size;
+            }
+        }
+        // The mapping stays valid after the descriptor is closed
+        close(FileDescriptor);
+        if (DMapping && Validate() && static_cast<const SHeader *>(DMapping)->SourceHash == sourcehash) {
+            DHeader = static_cast<const SHeader *>(DMapping);
+        }
+    }
+
+    ~SImplementation() {
+        if (DMapping) {
+            munmap(DMapping, DSize);
+        }
+    }
+
+    // Checks the header and that every section, range and index stays inside the file
+    bool Validate() const {
+        auto Header = static_cast<const SHeader *>(DMapping);
+        if (std::memcmp(Header->Magic, Magic, sizeof(Magic)) || Header->Version != FormatVersion || Header->SectionCount != SectionCount) {
+            return false;
+        }
+        for (uint32_t Index = 0; Index < SectionCount; Index++) {
+            auto &Section = Header->Sections[Index];
+            if (Section.Offset % sizeof(uint64_t) || Section.Offset > DSize || Section.Count > (DSize - Section.Offset) / ElementSize(ESection(Index))) {
+                return false;
+            }
+        }
+        auto SectionData = [&](ESection section) {
+            return static_cast<const char *>(DMapping) + Header->Sections[section].Offset;
+        };
+        auto SectionCountOf = [&](ESection section) {
+            return Header->Sections[section].Count;
+        };
+        // Offsets have one entry more than their owners, ascend and end within what they index
+        auto RangesValid = [&](ESection offsets, ESection owners, ESection ranged) {
+            if (SectionCountOf(offsets) != SectionCountOf(owners) + 1) {
+                return false;
+            }
+            auto Offsets = reinterpret_cast<const uint64_t *>(SectionData(offsets));
+            for (uint64_t Index = 1; Index < SectionCountOf(offsets); Index++) {
+                if (Offsets[Index] < Offsets[Index - 1]) {
+                    return false;
+                }
+            }
+            return Offsets[SectionCountOf(offsets) - 1] <= SectionCountOf(ranged);
+        };
+        auto IndexesValid = [&](ESection indexes, uint64_t limit) {
+            auto Indexes = reinterpret_cast<const uint32_t *>(SectionData(indexes));
+            return std::all_of(Indexes, Indexes + SectionCountOf(indexes), [limit](uint32_t index){ return index < limit; });
+        };
+        auto NodeTotal = SectionCountOf(NodeIDs), WayTotal = SectionCountOf(WayIDs), StopTotal = SectionCountOf(StopIDs);
+        if (SectionCountOf(NodeLatitudes) != NodeTotal || SectionCountOf(NodeLongitudes) != NodeTotal || SectionCountOf(NodeOrder) != NodeTotal ||
+            SectionCountOf(WayOrder) != WayTotal || SectionCountOf(StopNodeIDs) != StopTotal || SectionCountOf(StopOrder) != StopTotal) {
+            return false;
+        }
+        if (!RangesValid(NodeAttributeOffsets, NodeIDs, Attributes) || !RangesValid(WayNodeOffsets, WayIDs, WayNodeIDs) ||
+            !RangesValid(WayAttributeOffsets, WayIDs, Attributes) || !RangesValid(RouteStopOffsets, RouteNames, RouteStopIDs) ||
+            !SectionCountOf(StringOffsets)) {
+            return false;
+        }
+        auto StringTotal = SectionCountOf(StringOffsets) - 1;
+        auto Strings = reinterpret_cast<const uint64_t *>(SectionData(StringOffsets));
+        for (uint64_t Index = 1; Index <= StringTotal; Index++) {
+            if (Strings[Index] < Strings[Index - 1]) {
+                return false;
+            }
+        }
+        if (Strings[0] || Strings[StringTotal] > SectionCountOf(StringData)) {
+            return false;
+        }
+        auto AttributeList = reinterpret_cast<const SAttribute *>(SectionData(Attributes));
+        for (uint64_t Index = 0; Index < SectionCountOf(Attributes); Index++) {
+            if (AttributeList[Index].Key >= StringTotal || AttributeList[Index].Value >= StringTotal) {
+                return false;
+            }
+        }
+        return IndexesValid(NodeOrder, NodeTotal) && IndexesValid(WayOrder, WayTotal) && IndexesValid(StopOrder, StopTotal) && IndexesValid(RouteNames, StringTotal);
+    }
+
+    template <typename TElement>
+    const TElement *Section(ESection section) const {
+        return reinterpret_cast<const TElement *>(static_cast<const char *>(DMapping) + DHeader->Sections[section].Offset);
+    }
+
+    std::size_t Count(ESection section) const {
+        return DHeader ? DHeader->Sections[section].Count : 0;
+    }
+
+    std::string_view String(uint32_t index) const {
+        auto Offsets = Section<uint64_t>(StringOffsets);
+        return std::string_view(Section<char>(StringData) + Offsets[index], Offsets[index + 1] - Offsets[index]);
+    }
+
+    std::size_t AttributeCount(ESection offsets, std::size_t owner) const {
+        auto Offsets = Section<uint64_t>(offsets);
+        return Offsets[owner + 1] - Offsets[owner];
+    }
+
+    std::string AttributeKey(ESection offsets, std::size_t owner, std::size_t index) const {
+        if (index >= AttributeCount(offsets, owner)) {
+            return "";
+        }
+        return std::string(String(Section<SAttribute>(Attributes)[Section<uint64_t>(offsets)[owner] + index].Key));
+    }
+
+    const SAttribute *FindAttribute(ESection offsets, std::size_t owner, const std::string &key) const {
+        auto Offsets = Section<uint64_t>(offsets);
+        auto AttributeList = Section<SAttribute>(Attributes);
+        for (auto Index = Offsets[owner]; Index < Offsets[owner + 1]; Index++) {
+            if (String(AttributeList[Index].Key) == key) {
+                return AttributeList + Index;
+            }
+        }
+        return nullptr;
+    }
+
+    // Binary search of an Order section, the first of any repeated IDs is found
+    std::size_t FindByID(ESection ids, ESection order, uint64_t id) const {
+        if (!Count(ids)) {
+            return NotFound;
+        }
+        auto IDs = Section<uint64_t>(ids);
+        auto Order = Section<uint32_t>(order);
+        auto Search = std::lower_bound(Order, Order + Count(order), id, [IDs](uint32_t index, uint64_t value){
+            return IDs[index] < value;
+        });
+        if (Search != Order + Count(order) && IDs[*Search] == id) {
+            return *Search;
+        }
+        return NotFound;
+    }
+
+    // Builds the file in memory section by section
+    struct SWriter {
+        std::vector<char> Data;
+        SHeader Header = {};
+        std::unordered_map<std::string, uint32_t> Atoms;
+        std::vector<uint64_t> StringOffsetList = {0};
+        std::vector<char> StringBytes;
+
+        SWriter(uint64_t sourcehash) : Data(sizeof(SHeader)) {
+            std::memcpy(Header.Magic, Magic, sizeof(Magic));
+            Header.Version = FormatVersion;
+            Header.SectionCount = SectionCount;
+            Header.SourceHash = sourcehash;
+        }
+
+        uint32_t Intern(const std::string &str) {
+            auto Search = Atoms.find(str);
+            if (Search != Atoms.end()) {
+                return Search->second;
+            }
+            uint32_t Atom = Atoms.size();
+            Atoms.emplace(str, Atom);
+            StringBytes.insert(StringBytes.end(), str.begin(), str.end());
+            StringOffsetList.push_back(StringBytes.size());
+            return Atom;
+        }
+
+        template <typename TElement>
+        void Append(ESection section, const std::vector<TElement> &elements) {
+            Data.resize((Data.size() + sizeof(uint64_t) - 1) / sizeof(uint64_t) * sizeof(uint64_t));
+            Header.Sections[section].Offset = Data.size();
+            Header.Sections[section].Count = elements.size();
+            auto Bytes = reinterpret_cast<const char *>(elements.data());
+            Data.insert(Data.end(), Bytes, Bytes + elements.size() * sizeof(TElement));
+        }
+
+        // Indexes sorted by ID, the sort is stable so the first of any repeated IDs comes first
+        static std::vector<uint32_t> Order(const std::vector<uint64_t> &ids) {
+            std::vector<uint32_t> Indexes(ids.size());
+            std::iota(Indexes.begin(), Indexes.end(), 0);
+            std::stable_sort(Indexes.begin(), Indexes.end(), [&ids](uint32_t left, uint32_t right){
+                return ids[left] < ids[right];
+            });
+            return Indexes;
+        }
+
+        template <typename TElement>
+        void AppendAttributes(const TElement &element, std::vector<SAttribute> &attributes, std::vector<uint64_t> &offsets) {
+            for (std::size_t Index = 0; Index < element.AttributeCount(); Index++) {
+                auto Key = element.GetAttributeKey(Index);
+                attributes.push_back({Intern(Key), Intern(element.GetAttribute(Key))});
+            }
+            offsets.push_back(attributes.size());
+        }
+
+        void Finish() {
+            Append(StringOffsets, StringOffsetList);
+            Append(StringData, StringBytes);
+            std::memcpy(Data.data(), &Header, sizeof(SHeader));
+        }
+    };
+};
+
+constexpr char CBinaryStreetMap::SImplementation::Magic[8];
+
+CBinaryStreetMap::CBinaryStreetMap(const std::string &filename, uint64_t sourcehash){
+    DImplementation = std::make_shared<SImplementation>(filename, sourcehash);
+}
+
+CBinaryStreetMap::~CBinaryStreetMap() = default;
+
+bool CBinaryStreetMap::Loaded() const noexcept {
+    return DImplementation->DHeader != nullptr;
+}
+
+std::shared_ptr<CBusSystem> CBinaryStreetMap::BusSystem() const noexcept {
+    return std::make_shared<SImplementation::SBusSystem>(DImplementation);
+}
+
+uint64_t CBinaryStreetMap::SourceHash(const std::vector<std::shared_ptr<CDataSource>> &sources){
+    auto Hash = BinaryIO::Hash(nullptr, 0);
+    for (auto &Source : sources) {
+        Hash = BinaryIO::HashSource(*Source, Hash);
+    }
+    return Hash;
+}
+
+bool CBinaryStreetMap::Write(const CStreetMap &streetmap, const CBusSystem &bussystem, uint64_t sourcehash, std::shared_ptr<CDataSink> sink){
+    using SWriter = SImplementation::SWriter;
+    SWriter Writer(sourcehash);
+    std::vector<SImplementation::SAttribute> AttributeList;
+
+    std::vector<uint64_t> IDs, Offsets = {0};
+    std::vector<double> Latitudes, Longitudes;
+    for (std::size_t Index = 0; Index < streetmap.NodeCount(); Index++) {
+        auto Node = streetmap.NodeByIndex(Index);
+        IDs.push_back(Node->ID());
+        Latitudes.push_back(Node->Location().first);
+        Longitudes.push_back(Node->Location().second);
+        Writer.AppendAttributes(*Node, AttributeList, Offsets);
+    }
+    Writer.Append(SImplementation::NodeIDs, IDs);
+    Writer.Append(SImplementation::NodeLatitudes, Latitudes);
+    Writer.Append(SImplementation::NodeLongitudes, Longitudes);
+    Writer.Append(SImplementation::NodeOrder, SWriter::Order(IDs));
+    Writer.Append(SImplementation::NodeAttributeOffsets, Offsets);
+
+    std::vector<uint64_t> WayNodes, WayNodeOffsets = {0};
+    IDs.clear();
+    // Way attributes follow the node attributes in the same section
+    Offsets = {AttributeList.size()};
+    for (std::size_t Index = 0; Index < streetmap.WayCount(); Index++) {
+        auto Way = streetmap.WayByIndex(Index);
+        IDs.push_back(Way->ID());
+        for (std::size_t NodeIndex = 0; NodeIndex < Way->NodeCount(); NodeIndex++) {
+            WayNodes.push_back(Way->GetNodeID(NodeIndex));
+        }
+        WayNodeOffsets.push_back(WayNodes.size());
+        Writer.AppendAttributes(*Way, AttributeList, Offsets);
+    }
+    Writer.Append(SImplementation::WayIDs, IDs);
+    Writer.Append(SImplementation::WayOrder, SWriter::Order(IDs));
+    Writer.Append(SImplementation::WayNodeOffsets, WayNodeOffsets);
+    Writer.Append(SImplementation::WayNodeIDs, WayNodes);
+    Writer.Append(SImplementation::WayAttributeOffsets, Offsets);
+    Writer.Append(SImplementation::Attributes, AttributeList);
+
+    std::vector<uint64_t> StopNodes;
+    IDs.clear();
+    for (std::size_t Index = 0; Index < bussystem.StopCount(); Index++) {
+        auto Stop = bussystem.StopByIndex(Index);
+        IDs.push_back(Stop->ID());
+        StopNodes.push_back(Stop->NodeID());
+    }
+    Writer.Append(SImplementation::StopIDs, IDs);
+    Writer.Append(SImplementation::StopNodeIDs, StopNodes);
+    Writer.Append(SImplementation::StopOrder, SWriter::Order(IDs));
+
+    std::vector<uint32_t> Names;
+    IDs.clear();
+    Offsets = {0};
+    for (std::size_t Index = 0; Index < bussystem.RouteCount(); Index++) {
+        auto Route = bussystem.RouteByIndex(Index);
+        Names.push_back(Writer.Intern(Route->Name()));
+        for (std::size_t StopIndex = 0; StopIndex < Route->StopCount(); StopIndex++) {
+            IDs.push_back(Route->GetStopID(StopIndex));
+        }
+        Offsets.push_back(IDs.size());
+    }
+    Writer.Append(SImplementation::RouteNames, Names);
+    Writer.Append(SImplementation::RouteStopOffsets, Offsets);
+    Writer.Append(SImplementation::RouteStopIDs, IDs);
+
+    Writer.Finish();
+    return sink && sink->Write(Writer.Data);
+}
+
+std::size_t CBinaryStreetMap::NodeCount() const noexcept {
+    return DImplementation->Count(SImplementation::NodeIDs);
+}
+
+std::size_t CBinaryStreetMap::WayCount() const noexcept {
+    return DImplementation->Count(SImplementation::WayIDs);
+}
+
+std::shared_ptr<CStreetMap::SNode> CBinaryStreetMap::NodeByIndex(std::size_t index) const noexcept {
+    if (index >= NodeCount()) {
+        return nullptr;
+    }
+    return std::make_shared<SImplementation::SNodeView>(DImplementation, index);
+}
+
+std::shared_ptr<CStreetMap::SNode> CBinaryStreetMap::NodeByID(TNodeID id) const noexcept {
+    auto Index = DImplementation->FindByID(SImplementation::NodeIDs, SImplementation::NodeOrder, id);
+    if (Index == SImplementation::NotFound) {
+        return nullptr;
+    }
+    return std::make_shared<SImplementation::SNodeView>(DImplementation, Index);
+}
+
+std::shared_ptr<CStreetMap::SWay> CBinaryStreetMap::WayByIndex(std::size_t index) const noexcept {
+    if (index >= WayCount()) {
+        return nullptr;
+    }
+    return std::make_shared<SImplementation::SWayView>(DImplementation, index);
+}
+
+std::shared_ptr<CStreetMap::SWay> CBinaryStreetMap::WayByID(TWayID id) const noexcept {
+    auto Index = DImplementation->FindByID(SImplementation::WayIDs, SImplementation::WayOrder, id);
+    if (Index == SImplementation::NotFound) {
+        return nullptr;
+    }
+    return std::make_shared<SImplementation::SWayView>(DImplementation, Index);
+}
@@ -2,6 +2,7 @@
 #include "CSVBusSystem.h"
 #include "DSVReader.h"
 #include "StringDataSource.h"
+#include "StringUtils.h"
 #include <memory>
 #include <unordered_map>
 #include <vector>
@@ -9,11 +10,16 @@
 #include <string>
 #include <iostream>
 #include <algorithm> // For std::sort
+#include <charconv>
 
 struct CBusSystemIndexer::SImplementation {
     std::vector<std::shared_ptr<SStop>> Stops;
     std::vector<std::shared_ptr<SRoute>> Routes;
     std::unordered_map<TNodeID, std::shared_ptr<SStop>> NodeIDToStop;
+    // Routes (in name order) that go directly from the stop at the first node to the stop at the second
+    std::unordered_map<std::pair<TNodeID, TNodeID>, std::vector<std::shared_ptr<SRoute>>, SNodePairHash> RoutesBySegment;
+    std::vector<std::shared_ptr<SSegmentPath>> SegmentPaths;
+    std::unordered_map<std::pair<TNodeID, TNodeID>, std::shared_ptr<SSegmentPath>, SNodePairHash> SegmentPathsByNodes;
 
     struct CConcreteStop : public SStop {
         CBusSystem::TStopID DStopID;
@@ -50,6 +56,7 @@ struct CBusSystemIndexer::SImplementation {
 
     SImplementation(std::shared_ptr<CBusSystem> bussystem) {
         // Load stops
+        std::unordered_map<CBusSystem::TStopID, TNodeID> StopIDToNodeID;
         for (std::size_t StopIndex = 0; StopIndex < bussystem->StopCount(); StopIndex++) {
             auto Stop = bussystem->StopByIndex(StopIndex);
             if (Stop) {
@@ -57,6 +64,7 @@ struct CBusSystemIndexer::SImplementation {
                 ConcreteStop->DStopID = Stop->ID();
                 ConcreteStop->DNodeID = Stop->NodeID();
                 NodeIDToStop[ConcreteStop->DNodeID] = ConcreteStop;
+                StopIDToNodeID[ConcreteStop->DStopID] = ConcreteStop->DNodeID;
                 Stops.push_back(ConcreteStop);
             }
         }
@@ -83,6 +91,97 @@ struct CBusSystemIndexer::SImplementation {
         std::sort(Routes.begin(), Routes.end(), [](const std::shared_ptr<SRoute>& a, const std::shared_ptr<SRoute>& b) {
             return a->Name() < b->Name();
         });
+
+        // Index each pair of consecutive stops so route lookups do not scan every route
+        for (auto& Route : Routes) {
+            for (std::size_t StopIndex = 1; StopIndex < Route->StopCount(); StopIndex++) {
+                auto SourceNode = StopIDToNodeID.find(Route->GetStopID(StopIndex - 1));
+                auto DestinationNode = StopIDToNodeID.find(Route->GetStopID(StopIndex));
+                if (SourceNode != StopIDToNodeID.end() && DestinationNode != StopIDToNodeID.end()) {
+                    auto& SegmentRoutes = RoutesBySegment[std::make_pair(SourceNode->second, DestinationNode->second)];
+                    if (SegmentRoutes.empty() || SegmentRoutes.back() != Route) {
+                        SegmentRoutes.push_back(Route);
+                    }
+                }
+            }
+        }
+    }
+
+    static bool ParseNodeID(const std::string &str, TNodeID &id) {
+        auto Text = StringUtils::Strip(str);
+        auto Result = std::from_chars(Text.data(), Text.data() + Text.size(), id);
+        return !Text.empty() && Result.ec == std::errc() && Result.ptr == Text.data() + Text.size();
+    }
+
+    // Columns are found by their heading, rows that do not parse or do not follow a route are skipped
+    void LoadSegmentPaths(std::shared_ptr<CDSVReader> buspaths, std::shared_ptr<CStreetMap> streetmap, const std::unordered_map<TNodeID, TNodeID> &movednodes) {
+        auto MovedNode = [&movednodes](TNodeID id) {
+            auto Search = movednodes.find(id);
+            return Search == movednodes.end() ? id : Search->second;
+        };
+        std::vector<std::string> Row;
+        if (!buspaths->ReadRow(Row)) {
+            return;
+        }
+        auto SourceIndex = std::find(Row.begin(), Row.end(), "src_id") - Row.begin();
+        auto DestinationIndex = std::find(Row.begin(), Row.end(), "dest_id") - Row.begin();
+        auto PathIndex = std::find(Row.begin(), Row.end(), "path") - Row.begin();
+        auto ColumnCount = std::max({SourceIndex, DestinationIndex, PathIndex}) + 1;
+        if (ColumnCount > std::ptrdiff_t(Row.size())) {
+            return;
+        }
+        while (!buspaths->End()) {
+            if (!buspaths->ReadRow(Row) || std::ptrdiff_t(Row.size()) < ColumnCount) {
+                continue;
+            }
+            auto SegmentPath = std::make_shared<SSegmentPath>();
+            TNodeID Source, Destination;
+            if (!ParseNodeID(Row[SourceIndex], Source) || !ParseNodeID(Row[DestinationIndex], Destination)) {
+                continue;
+            }
+            SegmentPath->DSource = MovedNode(Source);
+            SegmentPath->DDestination = MovedNode(Destination);
+            auto Segment = std::make_pair(SegmentPath->DSource, SegmentPath->DDestination);
+            if (RoutesBySegment.find(Segment) == RoutesBySegment.end()) {
+                continue;
+            }
+            bool Valid = true;
+            for (auto &NodeText : StringUtils::Split(Row[PathIndex], ",")) {
+                TNodeID NodeID;
+                auto Node = ParseNodeID(NodeText, NodeID) ? streetmap->NodeByID(NodeID) : nullptr;
+                if (!Node) {
+                    Valid = false;
+                    break;
+                }
+                SegmentPath->DNodeIDs.push_back(NodeID);
+            }
+            if (!Valid || SegmentPath->DNodeIDs.empty() || SegmentPath->DNodeIDs.front() != Source || SegmentPath->DNodeIDs.back() != Destination) {
+                continue;
+            }
+            // Paths of moved stops go on from (or up to) the new node, which is often the next one on the path
+            auto &Nodes = SegmentPath->DNodeIDs;
+            if (Source != SegmentPath->DSource) {
+                if (Nodes.size() > 1 && Nodes[1] == SegmentPath->DSource) {
+                    Nodes.erase(Nodes.begin());
+                } else {
+                    Nodes.front() = SegmentPath->DSource;
+                }
+            }
+            if (Destination != SegmentPath->DDestination) {
+                if (Nodes.size() > 1 && Nodes[Nodes.size() - 2] == SegmentPath->DDestination) {
+                    Nodes.pop_back();
+                } else {
+                    Nodes.back() = SegmentPath->DDestination;
+                }
+            }
+            SegmentPathsByNodes[Segment] = SegmentPath;
+        }
+        for (auto &SegmentPath : SegmentPathsByNodes) {
+            SegmentPaths.push_back(SegmentPath.second);
+        }
+        std::sort(SegmentPaths.begin(), SegmentPaths.end(), [](const std::shared_ptr<SSegmentPath>& a, const std::shared_ptr<SSegmentPath>& b) {
+            return std::make_pair(a->DSource, a->DDestination) < std::make_pair(b->DSource, b->DDestination);
+        });
     }
 
     std::shared_ptr<SStop> StopByNodeID(TNodeID id) const noexcept {
@@ -100,6 +199,11 @@ CBusSystemIndexer::CBusSystemIndexer(std::shared_ptr<CBusSystem> bussystem) {
     DImplementation = std::make_unique<SImplementation>(bussystem);
 }
 
+CBusSystemIndexer::CBusSystemIndexer(std::shared_ptr<CBusSystem> bussystem, std::shared_ptr<CDSVReader> buspaths, std::shared_ptr<CStreetMap> streetmap, const std::unordered_map<TNodeID, TNodeID> &movednodes) {
+    DImplementation = std::make_unique<SImplementation>(bussystem);
+    DImplementation->LoadSegmentPaths(buspaths, streetmap, movednodes);
+}
+
 CBusSystemIndexer::~CBusSystemIndexer() = default;
 
 std::size_t CBusSystemIndexer::StopCount() const noexcept {
@@ -129,30 +233,33 @@ std::shared_ptr<CBusSystemIndexer::SStop> CBusSystemIndexer::StopByNodeID(TNodeI
 }
 
 bool CBusSystemIndexer::RoutesByNodeIDs(TNodeID src, TNodeID dest, std::unordered_set<std::shared_ptr<SRoute>>& routes) const noexcept {
-    auto SourceStop = StopByNodeID(src);
-    auto DestinationStop = StopByNodeID(dest);
-    if (SourceStop && DestinationStop) {
-        for (auto& Route : DImplementation->Routes) {
-            bool FoundSource = false;
-            bool FoundDestination = false;
-            for (std::size_t StopIndex = 0; StopIndex < Route->StopCount(); StopIndex++) {
-                if (Route->GetStopID(StopIndex) == SourceStop->ID()) {
-                    FoundSource = true;
-                }
-                if (Route->GetStopID(StopIndex) == DestinationStop->ID()) {
-                    FoundDestination = true;
-                }
-            }
-            if (FoundSource && FoundDestination) {
-                routes.insert(Route);
-            }
-        }
-        return !routes.empty();
+    auto Search = DImplementation->RoutesBySegment.find(std::make_pair(src, dest));
+    if (Search == DImplementation->RoutesBySegment.end()) {
+        return false;
     }
-    return false;
+    routes.insert(Search->second.begin(), Search->second.end());
+    return true;
 }
 
 bool CBusSystemIndexer::RouteBetweenNodeIDs(TNodeID src, TNodeID dest) const noexcept {
-    std::unordered_set<std::shared_ptr<SRoute>> Routes;
-    return RoutesByNodeIDs(src, dest, Routes);
-}
\ No newline at end of file
+    return DImplementation->RoutesBySegment.find(std::make_pair(src, dest)) != DImplementation->RoutesBySegment.end();
+}
+
+std::size_t CBusSystemIndexer::SegmentPathCount() const noexcept {
+    return DImplementation->SegmentPaths.size();
+}
+
+std::shared_ptr<CBusSystemIndexer::SSegmentPath> CBusSystemIndexer::SegmentPathByIndex(std::size_t index) const noexcept {
+    if (index >= DImplementation->SegmentPaths.size()) {
+        return nullptr;
+    }
+    return DImplementation->SegmentPaths[index];
+}
+
+std::shared_ptr<CBusSystemIndexer::SSegmentPath> CBusSystemIndexer::SegmentPathByNodeIDs(TNodeID src, TNodeID dest) const noexcept {
+    auto Search = DImplementation->SegmentPathsByNodes.find(std::make_pair(src, dest));
+    if (Search == DImplementation->SegmentPathsByNodes.end()) {
+        return nullptr;
+    }
+    return Search->second;
+}
@@ -59,6 +59,9 @@ struct CCSVBusSystem::SImplementation {
 
     std::vector<std::shared_ptr<CConcreteStop>> Stops;
     std::vector<std::shared_ptr<CConcreteRoute>> Routes;
+    // Lookups by ID and name, the first stop loaded with an ID wins like a scan of Stops would
+    std::unordered_map<TStopID, std::shared_ptr<CConcreteStop>> StopsByID;
+    std::unordered_map<std::string, std::shared_ptr<CConcreteRoute>> RoutesByName;
     int StopCount = 0;
     int RouteCount = 0;
 
@@ -76,6 +79,7 @@ struct CCSVBusSystem::SImplementation {
                     stop->DStopID = std::stoull(stop_id);
                     stop->DNodeID = std::stoull(node_id);
                     Stops.push_back(stop);
+                    StopsByID.emplace(stop->DStopID, stop);
                     StopCount++;
                     // std::cout << "Stop ID: " << stop->DStopID << " Node ID: " << stop->DNodeID << std::endl;
                 }
@@ -86,23 +90,19 @@ struct CCSVBusSystem::SImplementation {
             if (routesrc->ReadRow(row)){
                 auto route_name = StringUtils::Strip(row[0]);
                 auto stop_id = StringUtils::Strip(row[1]);
-                bool found = false;
                 if (!IsNumber(stop_id)){
                     continue;
                 } else {
-                    for (auto &Route : Routes){
-                        if (Route->DRouteName == route_name){
-                            Route->DStopIDs.push_back(std::stoull(stop_id));
-                            found = true;
-                            // std::cout << "Route Name: " << Route->DRouteName << " Stop ID: " << Route->DStopIDs[0] << std::endl;
-                            break;
-                        }
+                    auto Search = RoutesByName.find(route_name);
+                    if (Search != RoutesByName.end()){
+                        Search->second->DStopIDs.push_back(std::stoull(stop_id));
                     }
-                    if (!found){
+                    else{
                         auto route = std::make_shared<CConcreteRoute>();
                         route->DRouteName = route_name;
                         route->DStopIDs.push_back(std::stoull(row[1]));
                         Routes.push_back(route);
+                        RoutesByName.emplace(route_name, route);
                         RouteCount++;
                         // std::cout << "Route Name: " << route->DRouteName << " Stop ID: " << route->DStopIDs[0] << std::endl;
                     }
@@ -142,12 +142,11 @@ std::shared_ptr<CBusSystem::SStop> CCSVBusSystem::StopByIndex(std::size_t index)
 
 // Returns the SStop specified by the stop id, nullptr if id is not in the stops
 std::shared_ptr<CBusSystem::SStop> CCSVBusSystem::StopByID(TStopID id) const noexcept {
-    for (auto &Stop : DImplementation->Stops){
-        if (Stop->ID() == id){
-            return Stop;
-        }
+    auto Search = DImplementation->StopsByID.find(id);
+    if (Search == DImplementation->StopsByID.end()) {
+        return nullptr;
     }
-    return nullptr;
+    return Search->second;
 }
 
 // Returns the SRoute specified by the index, nullptr if index >= RouteCount()
@@ -160,10 +159,9 @@ std::shared_ptr<CBusSystem::SRoute> CCSVBusSystem::RouteByIndex(std::size_t inde
 
 // Returns the SRoute specified by the name, nullptr if name is not in the routes
 std::shared_ptr<CBusSystem::SRoute> CCSVBusSystem::RouteByName(const std::string& name) const noexcept {
-    for (auto &Route : DImplementation->Routes){
-        if (Route->Name() == name){
-            return Route;
-        }
+    auto Search = DImplementation->RoutesByName.find(name);
+    if (Search == DImplementation->RoutesByName.end()) {
+        return nullptr;
     }
-    return nullptr;
+    return Search->second;
 }
\ No newline at end of file
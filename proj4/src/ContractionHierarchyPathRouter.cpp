@@ -0,0 +1,609 @@
+#include "ContractionHierarchyPathRouter.h"
+#include "DijkstraPathRouter.h"
+#include "PathSearchWorkspace.h"
+#include "IndexedHeap.h"
+#include "BinaryIO.h"
+#include <vector>
+#include <limits>
+#include <any>
+#include <chrono>
+#include <algorithm>
+
+// Define the SImplementation struct
+struct CContractionHierarchyPathRouter::SImplementation {
+
+    // Edge of the hierarchy, DMiddle is the contracted vertex a shortcut bypasses
+    struct SEdge {
+        TVertexID DOther;
+        double DWeight;
+        TVertexID DMiddle;
+    };
+
+    struct SOriginalEdge {
+        TVertexID DSource;
+        TVertexID DDestination;
+        double DWeight;
+    };
+
+    // Witness searches give up after settling this many vertices, which can only add extra shortcuts
+    static constexpr std::size_t WitnessSettleLimit = 64;
+    // Number of contractions between deadline checks
+    static constexpr std::size_t DeadlineCheckInterval = 64;
+
+    // Holds the vertex tags and original graph, and answers queries until the hierarchy is ready
+    CDijkstraPathRouter DFallback;
+    std::vector<SOriginalEdge> EdgeList;
+    bool IsContracted = false;
+
+    // Remaining graph while contracting, only holds edges between uncontracted vertices
+    std::vector<std::vector<SEdge>> OutEdges;
+    std::vector<std::vector<SEdge>> InEdges;
+    std::vector<std::size_t> DeletedNeighbors;
+    SPathSearchWorkspace Witness;
+    // Contraction state kept between Precompute calls, so one that runs out of time is resumed by the next.
+    // Vertices get an initial priority in ID order, then are contracted in priority order.
+    bool ContractionStarted = false;
+    std::size_t PrioritizedCount = 0;
+    std::size_t ContractedCount = 0;
+    CIndexedHeap<4> Order;
+    // Edges of each vertex to its higher ranked neighbors, fixed when the vertex is contracted
+    std::vector<std::vector<SEdge>> UpperOut;
+    std::vector<std::vector<SEdge>> UpperIn;
+
+    // Search graph, UpEdges of v lead to higher ranked vertices, DownEdges of v are the edges
+    // u -> v from higher ranked u, stored at v so the backward search can walk them in reverse
+    std::vector<std::size_t> UpOffsets;
+    std::vector<SEdge> UpEdges;
+    std::vector<std::size_t> DownOffsets;
+    std::vector<SEdge> DownEdges;
+    SPathSearchWorkspace Forward;
+    SPathSearchWorkspace Backward;
+
+    TVertexID AddVertex(std::any tag) noexcept {
+        IsContracted = false;
+        ContractionStarted = false;
+        return DFallback.AddVertex(tag);
+    }
+
+    bool AddEdge(TVertexID src, TVertexID dest, double weight, bool bidir) noexcept {
+        if (!DFallback.AddEdge(src, dest, weight, bidir)) {
+            return false;
+        }
+        EdgeList.push_back({src, dest, weight});
+        if (bidir) {
+            EdgeList.push_back({dest, src, weight});
+        }
+        IsContracted = false;
+        ContractionStarted = false;
+        return true;
+    }
+
+    // Keeps only the cheapest edge to each neighbor
+    static void AddOrImprove(std::vector<SEdge> &edges, TVertexID other, double weight, TVertexID middle) {
+        for (auto &Edge : edges) {
+            if (Edge.DOther == other) {
+                if (weight < Edge.DWeight) {
+                    Edge.DWeight = weight;
+                    Edge.DMiddle = middle;
+                }
+                return;
+            }
+        }
+        edges.push_back({other, weight, middle});
+    }
+
+    static void RemoveNeighbor(std::vector<SEdge> &edges, TVertexID other) {
+        edges.erase(std::remove_if(edges.begin(), edges.end(), [other](const SEdge &edge) {
+            return edge.DOther == other;
+        }), edges.end());
+    }
+
+    // Local Dijkstra from src that avoids the vertex being contracted
+    void WitnessSearch(TVertexID src, TVertexID skip, double maxDist) {
+        Witness.Reset(OutEdges.size());
+        Witness.Relax(src, 0, CPathRouter::InvalidVertexID);
+        Witness.Heap.Update(src, 0);
+        std::size_t Settled = 0;
+        while (!Witness.Heap.Empty() && Witness.Heap.TopKey() <= maxDist && Settled < WitnessSettleLimit) {
+            TVertexID u = Witness.Heap.TopItem();
+            double DistU = Witness.Heap.TopKey();
+            Witness.Heap.Pop();
+            Settled++;
+            for (const auto &Edge : OutEdges[u]) {
+                if (Edge.DOther == skip) {
+                    continue;
+                }
+                auto NewDist = DistU + Edge.DWeight;
+                if (NewDist < Witness.Distance(Edge.DOther)) {
+                    Witness.Relax(Edge.DOther, NewDist, u);
+                    Witness.Heap.Update(Edge.DOther, NewDist);
+                }
+            }
+        }
+    }
+
+    // Finds the shortcuts contracting vertex would need, adding them to the remaining graph if requested
+    std::size_t ProcessShortcuts(TVertexID vertex, bool add) {
+        std::size_t Shortcuts = 0;
+        for (const auto &InEdge : InEdges[vertex]) {
+            auto u = InEdge.DOther;
+            double MaxOutWeight = -1;
+            for (const auto &OutEdge : OutEdges[vertex]) {
+                if (OutEdge.DOther != u) {
+                    MaxOutWeight = std::max(MaxOutWeight, OutEdge.DWeight);
+                }
+            }
+            if (MaxOutWeight < 0) {
+                continue;
+            }
+            WitnessSearch(u, vertex, InEdge.DWeight + MaxOutWeight);
+            for (const auto &OutEdge : OutEdges[vertex]) {
+                auto x = OutEdge.DOther;
+                auto ViaWeight = InEdge.DWeight + OutEdge.DWeight;
+                if (x == u || Witness.Distance(x) <= ViaWeight) {
+                    continue;
+                }
+                Shortcuts++;
+                if (add) {
+                    AddOrImprove(OutEdges[u], x, ViaWeight, vertex);
+                    AddOrImprove(InEdges[x], u, ViaWeight, vertex);
+                }
+            }
+        }
+        return Shortcuts;
+    }
+
+    // Edge difference plus the number of already contracted neighbors, lower is contracted first
+    double Priority(TVertexID vertex) {
+        double Shortcuts = ProcessShortcuts(vertex, false);
+        double Removed = InEdges[vertex].size() + OutEdges[vertex].size();
+        return Shortcuts - Removed + DeletedNeighbors[vertex];
+    }
+
+    static void PackEdges(const std::vector<std::vector<SEdge>> &edges, std::vector<std::size_t> &offsets, std::vector<SEdge> &packed) {
+        offsets.assign(edges.size() + 1, 0);
+        packed.clear();
+        for (std::size_t Index = 0; Index < edges.size(); Index++) {
+            packed.insert(packed.end(), edges[Index].begin(), edges[Index].end());
+            offsets[Index + 1] = packed.size();
+        }
+    }
+
+    void StartContraction() {
+        std::size_t NumVertices = DFallback.VertexCount();
+        OutEdges.assign(NumVertices, {});
+        InEdges.assign(NumVertices, {});
+        DeletedNeighbors.assign(NumVertices, 0);
+        for (const auto &Edge : EdgeList) {
+            // Self loops are never on a shortest path
+            if (Edge.DSource != Edge.DDestination) {
+                AddOrImprove(OutEdges[Edge.DSource], Edge.DDestination, Edge.DWeight, CPathRouter::InvalidVertexID);
+                AddOrImprove(InEdges[Edge.DDestination], Edge.DSource, Edge.DWeight, CPathRouter::InvalidVertexID);
+            }
+        }
+        Order.Clear();
+        Order.Resize(NumVertices);
+        UpperOut.assign(NumVertices, {});
+        UpperIn.assign(NumVertices, {});
+        PrioritizedCount = 0;
+        ContractedCount = 0;
+        ContractionStarted = true;
+    }
+
+    // Contracts one vertex, or requeues it if its priority went stale
+    void ContractNext() {
+        TVertexID Vertex = Order.TopItem();
+        Order.Pop();
+        // Priorities go stale as neighbors are contracted, so requeue if it is no longer the minimum
+        double CurrentPriority = Priority(Vertex);
+        if (!Order.Empty() && CurrentPriority > Order.TopKey()) {
+            Order.Update(Vertex, CurrentPriority);
+            return;
+        }
+
+        ProcessShortcuts(Vertex, true);
+        UpperOut[Vertex] = OutEdges[Vertex];
+        UpperIn[Vertex] = InEdges[Vertex];
+        for (const auto &Edge : UpperIn[Vertex]) {
+            RemoveNeighbor(OutEdges[Edge.DOther], Vertex);
+        }
+        for (const auto &Edge : UpperOut[Vertex]) {
+            RemoveNeighbor(InEdges[Edge.DOther], Vertex);
+        }
+        OutEdges[Vertex].clear();
+        InEdges[Vertex].clear();
+        ContractedCount++;
+
+        // Two way streets list a neighbor on both sides, so update each one once
+        std::vector<TVertexID> Neighbors;
+        for (const auto &Edge : UpperIn[Vertex]) {
+            Neighbors.push_back(Edge.DOther);
+        }
+        for (const auto &Edge : UpperOut[Vertex]) {
+            Neighbors.push_back(Edge.DOther);
+        }
+        std::sort(Neighbors.begin(), Neighbors.end());
+        Neighbors.erase(std::unique(Neighbors.begin(), Neighbors.end()), Neighbors.end());
+        for (auto Neighbor : Neighbors) {
+            DeletedNeighbors[Neighbor]++;
+            Order.Assign(Neighbor, Priority(Neighbor));
+        }
+    }
+
+    // Runs contraction steps until the hierarchy is built or the deadline passes
+    bool Contract(std::chrono::steady_clock::time_point deadline) {
+        if (!ContractionStarted) {
+            StartContraction();
+        }
+        std::size_t NumVertices = DFallback.VertexCount();
+        std::size_t Steps = 0;
+        while (PrioritizedCount < NumVertices) {
+            if (Steps++ % DeadlineCheckInterval == 0 && std::chrono::steady_clock::now() >= deadline) {
+                return false;
+            }
+            Order.Update(PrioritizedCount, Priority(PrioritizedCount));
+            PrioritizedCount++;
+        }
+        while (!Order.Empty()) {
+            if (Steps++ % DeadlineCheckInterval == 0 && std::chrono::steady_clock::now() >= deadline) {
+                return false;
+            }
+            ContractNext();
+        }
+
+        PackEdges(UpperOut, UpOffsets, UpEdges);
+        PackEdges(UpperIn, DownOffsets, DownEdges);
+        OutEdges.clear();
+        InEdges.clear();
+        UpperOut.clear();
+        UpperIn.clear();
+        ContractionStarted = false;
+        return true;
+    }
+
+    double PrecomputeProgress() const noexcept {
+        if (IsContracted) {
+            return 1.0;
+        }
+        if (!ContractionStarted) {
+            return 0.0;
+        }
+        // Prioritizing and contracting each count as one step per vertex
+        return double(PrioritizedCount + ContractedCount) / (2.0 * DFallback.VertexCount());
+    }
+
+    bool Precompute(std::chrono::steady_clock::time_point deadline) noexcept {
+        if (!IsContracted) {
+            IsContracted = Contract(deadline);
+        }
+        return IsContracted;
+    }
+
+    static constexpr uint32_t HierarchyMagic = 0x52504843; // "CHPR"
+    static constexpr uint32_t HierarchyVersion = 1;
+
+    // Identifies the graph a hierarchy was built for, so one is never loaded onto another graph
+    uint64_t GraphHash() const {
+        auto Hash = BinaryIO::Hash(EdgeList.data(), EdgeList.size() * sizeof(SOriginalEdge));
+        std::size_t NumVertices = DFallback.VertexCount();
+        return BinaryIO::Hash(&NumVertices, sizeof(NumVertices), Hash);
+    }
+
+    bool SaveHierarchy(std::shared_ptr<CDataSink> sink) const {
+        if (!IsContracted || !sink) {
+            return false;
+        }
+        std::vector<char> Buffer;
+        BinaryIO::Append(Buffer, HierarchyMagic);
+        BinaryIO::Append(Buffer, HierarchyVersion);
+        BinaryIO::Append(Buffer, GraphHash());
+        BinaryIO::AppendVector(Buffer, UpOffsets);
+        BinaryIO::AppendVector(Buffer, UpEdges);
+        BinaryIO::AppendVector(Buffer, DownOffsets);
+        BinaryIO::AppendVector(Buffer, DownEdges);
+        return sink->Write(Buffer);
+    }
+
+    // Offsets must index all of edges in order, and every edge must stay inside the graph
+    static bool SearchGraphValid(const std::vector<std::size_t> &offsets, const std::vector<SEdge> &edges, std::size_t numVertices) {
+        if (offsets.size() != numVertices + 1 || offsets.front() != 0 || offsets.back() != edges.size()) {
+            return false;
+        }
+        if (!std::is_sorted(offsets.begin(), offsets.end())) {
+            return false;
+        }
+        return std::all_of(edges.begin(), edges.end(), [numVertices](const SEdge &edge) {
+            return edge.DOther < numVertices && (edge.DMiddle < numVertices || edge.DMiddle == CPathRouter::InvalidVertexID);
+        });
+    }
+
+    bool LoadHierarchy(std::shared_ptr<CDataSource> source) {
+        if (!source) {
+            return false;
+        }
+        uint32_t Magic, Version;
+        uint64_t Hash;
+        if (!BinaryIO::Read(*source, Magic) || Magic != HierarchyMagic || !BinaryIO::Read(*source, Version) || Version != HierarchyVersion) {
+            return false;
+        }
+        // A hierarchy has at most one upward and one downward edge per pair of vertices
+        std::size_t NumVertices = DFallback.VertexCount();
+        uint64_t MaxEdges = uint64_t(NumVertices) * NumVertices;
+        std::vector<std::size_t> LoadedUpOffsets, LoadedDownOffsets;
+        std::vector<SEdge> LoadedUpEdges, LoadedDownEdges;
+        if (!BinaryIO::Read(*source, Hash) ||
+            !BinaryIO::ReadVector(*source, LoadedUpOffsets, NumVertices + 1) || !BinaryIO::ReadVector(*source, LoadedUpEdges, MaxEdges) ||
+            !BinaryIO::ReadVector(*source, LoadedDownOffsets, NumVertices + 1) || !BinaryIO::ReadVector(*source, LoadedDownEdges, MaxEdges)) {
+            return false;
+        }
+        if (Hash != GraphHash() || !SearchGraphValid(LoadedUpOffsets, LoadedUpEdges, NumVertices) || !SearchGraphValid(LoadedDownOffsets, LoadedDownEdges, NumVertices)) {
+            return false;
+        }
+        UpOffsets = std::move(LoadedUpOffsets);
+        UpEdges = std::move(LoadedUpEdges);
+        DownOffsets = std::move(LoadedDownOffsets);
+        DownEdges = std::move(LoadedDownEdges);
+        // Any contraction in progress is no longer needed
+        OutEdges.clear();
+        InEdges.clear();
+        UpperOut.clear();
+        UpperIn.clear();
+        ContractionStarted = false;
+        IsContracted = true;
+        return true;
+    }
+
+    static const SEdge *FindEdge(const std::vector<std::size_t> &offsets, const std::vector<SEdge> &edges, TVertexID vertex, TVertexID other) {
+        for (std::size_t EdgeIndex = offsets[vertex]; EdgeIndex < offsets[vertex + 1]; EdgeIndex++) {
+            if (edges[EdgeIndex].DOther == other) {
+                return &edges[EdgeIndex];
+            }
+        }
+        return nullptr;
+    }
+
+    // Appends the original vertices after src along the hierarchy edge src -> dest, adding the
+    // original edge weights to dist in path order. False if a shortcut does not unpack, which
+    // only a damaged hierarchy can cause.
+    bool UnpackEdge(TVertexID src, TVertexID dest, const SEdge *edge, std::vector<TVertexID> &path, double &dist) const {
+        // A shortest path visits each vertex at most once, and each shortcut splits into two edges
+        std::size_t StepsLeft = 2 * DFallback.VertexCount();
+        std::vector<std::pair<std::pair<TVertexID, TVertexID>, const SEdge *>> Pending = {{{src, dest}, edge}};
+        while (!Pending.empty()) {
+            auto [Ends, Edge] = Pending.back();
+            Pending.pop_back();
+            if (!Edge || !StepsLeft--) {
+                return false;
+            }
+            auto Middle = Edge->DMiddle;
+            if (Middle == CPathRouter::InvalidVertexID) {
+                path.push_back(Ends.second);
+                dist += Edge->DWeight;
+                continue;
+            }
+            // Middle was contracted before both ends, so Ends.first -> Middle is a down edge of Middle
+            // and Middle -> Ends.second is an up edge of Middle
+            auto FirstHalf = FindEdge(DownOffsets, DownEdges, Middle, Ends.first);
+            auto SecondHalf = FindEdge(UpOffsets, UpEdges, Middle, Ends.second);
+            Pending.push_back({{Middle, Ends.second}, SecondHalf});
+            Pending.push_back({{Ends.first, Middle}, FirstHalf});
+        }
+        return true;
+    }
+
+    // Upward search from vertex over one half of the hierarchy, run to completion. Calls
+    // visit(vertex, distance) for every vertex it settles.
+    template <typename TVisit>
+    void SearchUpward(TVertexID vertex, const std::vector<std::size_t> &offsets, const std::vector<SEdge> &edges, SPathSearchWorkspace &search, TVisit visit) {
+        search.Reset(DFallback.VertexCount());
+        search.Relax(vertex, 0, CPathRouter::InvalidVertexID);
+        search.Heap.Update(vertex, 0);
+        while (!search.Heap.Empty()) {
+            TVertexID u = search.Heap.TopItem();
+            double DistU = search.Heap.TopKey();
+            search.Heap.Pop();
+            visit(u, DistU);
+            for (std::size_t EdgeIndex = offsets[u]; EdgeIndex < offsets[u + 1]; EdgeIndex++) {
+                auto v = edges[EdgeIndex].DOther;
+                auto NewDist = DistU + edges[EdgeIndex].DWeight;
+                if (NewDist < search.Distance(v)) {
+                    search.Relax(v, NewDist, u);
+                    search.Heap.Update(v, NewDist);
+                }
+            }
+        }
+    }
+
+    // Bucket based many-to-many. A backward upward search from each destination leaves its
+    // distance in a bucket at every vertex it settles, then a forward upward search from each
+    // source meets those at the vertices it settles. Every shortest path has a highest ranked
+    // vertex that both searches reach, so the smallest sum over the buckets is the distance.
+    void FindDistances(const std::vector<TVertexID> &srcs, const std::vector<TVertexID> &dests, std::vector<std::vector<double>> &distances) {
+        if (!IsContracted) {
+            DFallback.FindDistances(srcs, dests, distances);
+            return;
+        }
+        distances.assign(srcs.size(), std::vector<double>(dests.size(), CPathRouter::NoPathExists));
+        std::size_t NumVertices = DFallback.VertexCount();
+        struct SBucketEntry {
+            std::size_t DColumn;
+            double DDistance;
+        };
+        std::vector<std::pair<TVertexID, SBucketEntry>> Entries;
+        for (std::size_t Column = 0; Column < dests.size(); Column++) {
+            if (dests[Column] < NumVertices) {
+                SearchUpward(dests[Column], DownOffsets, DownEdges, Backward, [&Entries, Column](TVertexID vertex, double dist) {
+                    Entries.push_back({vertex, {Column, dist}});
+                });
+            }
+        }
+        // Counting sort the entries into per vertex buckets, the entries of vertex v are [BucketOffsets[v], BucketOffsets[v + 1])
+        std::vector<std::size_t> BucketOffsets(NumVertices + 1, 0);
+        for (const auto &Entry : Entries) {
+            BucketOffsets[Entry.first + 1]++;
+        }
+        for (std::size_t Index = 0; Index < NumVertices; Index++) {
+            BucketOffsets[Index + 1] += BucketOffsets[Index];
+        }
+        std::vector<SBucketEntry> Buckets(Entries.size());
+        std::vector<std::size_t> NextSlot(BucketOffsets.begin(), BucketOffsets.end() - 1);
+        for (const auto &Entry : Entries) {
+            Buckets[NextSlot[Entry.first]++] = Entry.second;
+        }
+        for (std::size_t Row = 0; Row < srcs.size(); Row++) {
+            if (srcs[Row] >= NumVertices) {
+                continue;
+            }
+            auto &RowDistances = distances[Row];
+            SearchUpward(srcs[Row], UpOffsets, UpEdges, Forward, [&](TVertexID vertex, double dist) {
+                for (std::size_t Index = BucketOffsets[vertex]; Index < BucketOffsets[vertex + 1]; Index++) {
+                    auto &Entry = Buckets[Index];
+                    if (dist + Entry.DDistance < RowDistances[Entry.DColumn]) {
+                        RowDistances[Entry.DColumn] = dist + Entry.DDistance;
+                    }
+                }
+            });
+        }
+    }
+
+    double FindShortestPath(TVertexID src, TVertexID dest, std::vector<TVertexID> &path) noexcept {
+        path.clear();
+        if (!IsContracted) {
+            return DFallback.FindShortestPath(src, dest, path);
+        }
+        std::size_t NumVertices = DFallback.VertexCount();
+        if (src >= NumVertices || dest >= NumVertices) {
+            return CPathRouter::NoPathExists;
+        }
+
+        Forward.Reset(NumVertices);
+        Backward.Reset(NumVertices);
+        Forward.Relax(src, 0, CPathRouter::InvalidVertexID);
+        Forward.Heap.Update(src, 0);
+        Backward.Relax(dest, 0, CPathRouter::InvalidVertexID);
+        Backward.Heap.Update(dest, 0);
+
+        // Both searches only go up the hierarchy and meet at the highest ranked vertex on the path
+        double BestDist = std::numeric_limits<double>::infinity();
+        TVertexID MeetVertex = CPathRouter::InvalidVertexID;
+        if (src == dest) {
+            BestDist = 0;
+            MeetVertex = src;
+        }
+        while (!Forward.Heap.Empty() || !Backward.Heap.Empty()) {
+            bool IsForward = !Forward.Heap.Empty() && (Backward.Heap.Empty() || Forward.Heap.TopKey() <= Backward.Heap.TopKey());
+            auto &Active = IsForward ? Forward : Backward;
+            auto &Opposite = IsForward ? Backward : Forward;
+            const auto &ActiveOffsets = IsForward ? UpOffsets : DownOffsets;
+            const auto &ActiveEdges = IsForward ? UpEdges : DownEdges;
+            // The smaller of the two queue minimums can no longer lead to a better meeting
+            if (Active.Heap.TopKey() >= BestDist) {
+                break;
+            }
+
+            TVertexID u = Active.Heap.TopItem();
+            double DistU = Active.Heap.TopKey();
+            Active.Heap.Pop();
+            if (Opposite.Reached(u) && DistU + Opposite.Dist[u] < BestDist) {
+                BestDist = DistU + Opposite.Dist[u];
+                MeetVertex = u;
+            }
+            for (std::size_t EdgeIndex = ActiveOffsets[u]; EdgeIndex < ActiveOffsets[u + 1]; EdgeIndex++) {
+                auto v = ActiveEdges[EdgeIndex].DOther;
+                auto NewDist = DistU + ActiveEdges[EdgeIndex].DWeight;
+                if (NewDist < Active.Distance(v)) {
+                    Active.Relax(v, NewDist, u);
+                    Active.Heap.Update(v, NewDist);
+                    if (Opposite.Reached(v) && NewDist + Opposite.Dist[v] < BestDist) {
+                        BestDist = NewDist + Opposite.Dist[v];
+                        MeetVertex = v;
+                    }
+                }
+            }
+        }
+
+        if (MeetVertex == CPathRouter::InvalidVertexID) {
+            return CPathRouter::NoPathExists;
+        }
+
+        // Hierarchy vertices from src up to the meeting vertex and back down to dest
+        std::vector<TVertexID> UpwardPath;
+        for (TVertexID CurrentVertex = MeetVertex; CurrentVertex != CPathRouter::InvalidVertexID; CurrentVertex = Forward.ParentVertex[CurrentVertex]) {
+            UpwardPath.push_back(CurrentVertex);
+        }
+        std::reverse(UpwardPath.begin(), UpwardPath.end());
+
+        // Unpacking emits the original edges from src to dest in order, so summing them there
+        // gives exactly what a forward Dijkstra search would
+        double PathDist = 0;
+        path.push_back(src);
+        for (std::size_t Index = 1; Index < UpwardPath.size(); Index++) {
+            auto Edge = FindEdge(UpOffsets, UpEdges, UpwardPath[Index - 1], UpwardPath[Index]);
+            if (!UnpackEdge(UpwardPath[Index - 1], UpwardPath[Index], Edge, path, PathDist)) {
+                path.clear();
+                return CPathRouter::NoPathExists;
+            }
+        }
+        for (TVertexID CurrentVertex = MeetVertex; CurrentVertex != dest; CurrentVertex = Backward.ParentVertex[CurrentVertex]) {
+            auto NextVertex = Backward.ParentVertex[CurrentVertex];
+            auto Edge = FindEdge(DownOffsets, DownEdges, NextVertex, CurrentVertex);
+            if (!UnpackEdge(CurrentVertex, NextVertex, Edge, path, PathDist)) {
+                path.clear();
+                return CPathRouter::NoPathExists;
+            }
+        }
+        return PathDist;
+    }
+};
+
+CContractionHierarchyPathRouter::CContractionHierarchyPathRouter() {
+    DImplementation = std::make_unique<SImplementation>();
+    // Without a hierarchy, searching from both ends is the cheapest option that needs no preprocessing
+    DImplementation->DFallback.SetBidirectional(true);
+}
+
+CContractionHierarchyPathRouter::~CContractionHierarchyPathRouter() = default;
+
+std::size_t CContractionHierarchyPathRouter::VertexCount() const noexcept {
+    return DImplementation->DFallback.VertexCount();
+}
+
+CContractionHierarchyPathRouter::TVertexID CContractionHierarchyPathRouter::AddVertex(std::any tag) noexcept {
+    return DImplementation->AddVertex(tag);
+}
+
+std::any CContractionHierarchyPathRouter::GetVertexTag(TVertexID id) const noexcept {
+    return DImplementation->DFallback.GetVertexTag(id);
+}
+
+bool CContractionHierarchyPathRouter::AddEdge(TVertexID src, TVertexID dest, double weight, bool bidir) noexcept {
+    return DImplementation->AddEdge(src, dest, weight, bidir);
+}
+
+bool CContractionHierarchyPathRouter::Precompute(std::chrono::steady_clock::time_point deadline) noexcept {
+    return DImplementation->Precompute(deadline);
+}
+
+double CContractionHierarchyPathRouter::FindShortestPath(TVertexID src, TVertexID dest, std::vector<TVertexID> &path) noexcept {
+    return DImplementation->FindShortestPath(src, dest, path);
+}
+
+void CContractionHierarchyPathRouter::FindDistances(const std::vector<TVertexID> &srcs, const std::vector<TVertexID> &dests, std::vector<std::vector<double>> &distances) noexcept {
+    DImplementation->FindDistances(srcs, dests, distances);
+}
+
+double CContractionHierarchyPathRouter::PrecomputeProgress() const noexcept {
+    return DImplementation->PrecomputeProgress();
+}
+
+bool CContractionHierarchyPathRouter::Contracted() const noexcept {
+    return DImplementation->IsContracted;
+}
+
+bool CContractionHierarchyPathRouter::SaveHierarchy(std::shared_ptr<CDataSink> sink) const noexcept {
+    return DImplementation->SaveHierarchy(sink);
+}
+
+bool CContractionHierarchyPathRouter::LoadHierarchy(std::shared_ptr<CDataSource> source) noexcept {
+    return DImplementation->LoadHierarchy(source);
+}
@@ -1,113 +1,275 @@
 #include "DijkstraPathRouter.h"
+#include "PathSearchWorkspace.h"
 #include <vector>
-#include <unordered_map>
-#include <queue>
+#include <cstdint>
 #include <limits>
 #include <any>
 #include <chrono>
 #include <algorithm>
-#include <iostream>
+#include <cmath>
 
 // Define the SImplementation struct
 struct CDijkstraPathRouter::SImplementation {
 
-    // Create a vertex struct to store the vertex tag and adjacency list
-    struct Vertex {
-        std::any Tag;
-        std::vector<std::pair<TVertexID, double>> Edges; // Adjacency list with weights
+    // Edges are collected in insertion order while the graph is being built
+    struct SEdge {
+        TVertexID DSource;
+        TVertexID DDestination;
+        double DWeight;
     };
 
-    // Define a custom comparator for the priority queue
-    struct CompareDist {
-        // Since we are working with references to the distance map, when it is modified, the priority queue is updated
-        std::unordered_map<TVertexID, double>& Dist;
-        // Initialize the comparator with the distance map
-        CompareDist(std::unordered_map<TVertexID, double>& dist) : Dist(dist) {}
-        // Compare the distances of two vertices
-        bool operator()(TVertexID lhs, TVertexID rhs) const {
-            // Similar to std::greater but using the distance map
-            // Comparisons that return false have higher priority, so this creates a min-heap
-            return Dist[lhs] > Dist[rhs];
-        }
-    };
+    // Vertex IDs are dense (0..N-1), so tags are stored by index
+    std::vector<std::any> VertexTags;
+    std::vector<SEdge> EdgeList;
 
-    // Define the graph as an unordered map of vertices
-    std::unordered_map<TVertexID, Vertex> Graph;
-    // Initialize the next vertex ID to 0 when the struct is created
-    TVertexID NextVertexID = -1;
-    // Define infinity as the maximum value of a double
-    const double INF = std::numeric_limits<double>::infinity();
+    // Compressed sparse row form of EdgeList, the edges of vertex v are [Offsets[v], Offsets[v + 1])
+    std::vector<std::size_t> Offsets;
+    std::vector<TVertexID> Targets;
+    std::vector<double> Weights;
+    // Reverse adjacency in the same layout, the edges into vertex v are [ReverseOffsets[v], ReverseOffsets[v + 1])
+    std::vector<std::size_t> ReverseOffsets;
+    std::vector<TVertexID> ReverseSources;
+    std::vector<double> ReverseWeights;
+    // Set once the CSR arrays match EdgeList, cleared by any later AddVertex/AddEdge
+    bool Finalized = false;
+    SPathSearchWorkspace Search;
+    SPathSearchWorkspace BackwardSearch;
+    bool Bidirectional = false;
+    // When set, queries run A* keyed on distance plus this lower bound
+    THeuristic Heuristic;
+    // ALT landmarks, tables are vertex major so a vertex's distances to all landmarks are adjacent.
+    // FromLandmark[v * LandmarkCount + l] is the distance from landmark l to v, ToLandmark is v to l.
+    // Unreachable entries are infinity. LandmarksReady counts the landmarks whose tables are filled.
+    std::size_t LandmarkCount = 0;
+    std::size_t LandmarksReady = 0;
+    std::vector<TVertexID> Landmarks;
+    std::vector<float> FromLandmark;
+    std::vector<float> ToLandmark;
+    // Selection state kept between Precompute calls, so one that runs out of time is resumed by the next
+    bool LandmarksStarted = false;
+    bool LandmarksDone = false;
+    std::vector<double> LandmarkNearest;
+    TVertexID NextLandmark = 0;
+
+    void ResetLandmarks() {
+        LandmarksReady = 0;
+        LandmarksStarted = false;
+        LandmarksDone = false;
+        Landmarks.clear();
+    }
 
     TVertexID AddVertex(std::any tag) noexcept {
-        // Increment the vertex ID
-        NextVertexID++;
-        Vertex NewVertex;
-        NewVertex.Tag = tag;
-        // Add the new vertex to the graph
-        Graph[NextVertexID] = NewVertex;
-        return NextVertexID;
+        VertexTags.push_back(tag);
+        Finalized = false;
+        ResetLandmarks();
+        return VertexTags.size() - 1;
     }
 
     std::any GetVertexTag(TVertexID id) const noexcept {
-        auto Tag = Graph.find(id);
-        // find() returns an iterator to the end of the map if the key is not found
-        if (Tag != Graph.end()) {
-            return Tag->second.Tag;
+        if (id < VertexTags.size()) {
+            return VertexTags[id];
         }
         return std::any();
     }
 
     bool AddEdge(TVertexID src, TVertexID dest, double weight, bool bidir) noexcept {
-        if (Graph.find(src) == Graph.end() || Graph.find(dest) == Graph.end()) {
+        if (src >= VertexTags.size() || dest >= VertexTags.size()) {
             return false;
         }
-        // Graph[src] returns a vertex object
-        // Since Graph[src].Edges is an unordered map in the vertex object
-        Graph[src].Edges.push_back(std::pair(dest, weight)); // Add edge from src to dest with weight
+        EdgeList.push_back({src, dest, weight}); // Add edge from src to dest with weight
         if (bidir) {
-            Graph[dest].Edges.push_back(std::pair(src, weight)); // Add edge from dest to src with weight
+            EdgeList.push_back({dest, src, weight}); // Add edge from dest to src with weight
         }
+        Finalized = false;
+        ResetLandmarks();
         return true;
     }
 
-    bool Precompute(std::chrono::steady_clock::time_point deadline) noexcept {
-        // Perform any desired precomputation here
-        // For example, we can precompute shortest paths between all pairs of vertices
-        // using the Floyd-Warshall algorithm or any other suitable algorithm
+    // Counting sort of the edges by one endpoint, stable so each vertex keeps its insertion order
+    void PackEdges(bool reverse, std::vector<std::size_t> &offsets, std::vector<TVertexID> &others, std::vector<double> &weights) {
+        std::size_t NumVertices = VertexTags.size();
+        offsets.assign(NumVertices + 1, 0);
+        for (const auto &Edge : EdgeList) {
+            offsets[(reverse ? Edge.DDestination : Edge.DSource) + 1]++;
+        }
+        for (std::size_t Index = 0; Index < NumVertices; Index++) {
+            offsets[Index + 1] += offsets[Index];
+        }
+        others.resize(EdgeList.size());
+        weights.resize(EdgeList.size());
+        std::vector<std::size_t> NextSlot(offsets.begin(), offsets.end() - 1);
+        for (const auto &Edge : EdgeList) {
+            auto Slot = NextSlot[reverse ? Edge.DDestination : Edge.DSource]++;
+            others[Slot] = reverse ? Edge.DSource : Edge.DDestination;
+            weights[Slot] = Edge.DWeight;
+        }
+    }
+
+    void Finalize() {
+        if (Finalized) {
+            return;
+        }
+        PackEdges(false, Offsets, Targets, Weights);
+        PackEdges(true, ReverseOffsets, ReverseSources, ReverseWeights);
+        Finalized = true;
+    }
+
+    // Cheapest direct edge from src to dest, used to re-add a path's cost in forward order
+    double EdgeWeight(TVertexID src, TVertexID dest) const {
+        double Best = std::numeric_limits<double>::infinity();
+        for (std::size_t EdgeIndex = Offsets[src]; EdgeIndex < Offsets[src + 1]; EdgeIndex++) {
+            if (Targets[EdgeIndex] == dest && Weights[EdgeIndex] < Best) {
+                Best = Weights[EdgeIndex];
+            }
+        }
+        return Best;
+    }
+
+    // Plain Dijkstra from src to every vertex, over the reverse adjacency it gives distances into src
+    void SearchAll(TVertexID src, bool reverse) {
+        const auto &ActiveOffsets = reverse ? ReverseOffsets : Offsets;
+        const auto &ActiveVertices = reverse ? ReverseSources : Targets;
+        const auto &ActiveWeights = reverse ? ReverseWeights : Weights;
+        Search.Reset(VertexTags.size());
+        Search.Relax(src, 0, CPathRouter::InvalidVertexID);
+        Search.Heap.Update(src, 0);
+        while (!Search.Heap.Empty()) {
+            TVertexID u = Search.Heap.TopItem();
+            double DistU = Search.Dist[u];
+            Search.Heap.Pop();
+            for (std::size_t EdgeIndex = ActiveOffsets[u]; EdgeIndex < ActiveOffsets[u + 1]; EdgeIndex++) {
+                auto v = ActiveVertices[EdgeIndex];
+                auto NewDist = DistU + ActiveWeights[EdgeIndex];
+                if (NewDist < Search.Distance(v)) {
+                    Search.Relax(v, NewDist, u);
+                    Search.Heap.Update(v, NewDist);
+                }
+            }
+        }
+    }
+
+    // Copies the last SearchAll into one landmark column of a table
+    void StoreLandmarkDistances(std::vector<float> &table, std::size_t landmarkIndex) {
+        for (TVertexID Vertex = 0; Vertex < VertexTags.size(); Vertex++) {
+            table[Vertex * LandmarkCount + landmarkIndex] = Search.Reached(Vertex) ? float(Search.Dist[Vertex]) : std::numeric_limits<float>::infinity();
+        }
+    }
+
+    // Farthest point selection, each landmark is the vertex farthest from the ones already chosen.
+    // Vertices no landmark reaches count as farthest so every component gets covered.
+    // Each landmark is one unit of work, returns false if the deadline passed before all were done.
+    bool PrecomputeLandmarks(std::chrono::steady_clock::time_point deadline) {
+        std::size_t NumVertices = VertexTags.size();
+        if (!LandmarksStarted) {
+            LandmarksStarted = true;
+            if (!NumVertices) {
+                LandmarksDone = true;
+                return true;
+            }
+            FromLandmark.assign(NumVertices * LandmarkCount, std::numeric_limits<float>::infinity());
+            ToLandmark.assign(NumVertices * LandmarkCount, std::numeric_limits<float>::infinity());
+            LandmarkNearest.assign(NumVertices, std::numeric_limits<double>::infinity());
+            // The first landmark is the vertex farthest from an arbitrary start
+            SearchAll(0, false);
+            NextLandmark = 0;
+            for (TVertexID Vertex = 0; Vertex < NumVertices; Vertex++) {
+                if (Search.Reached(Vertex) && Search.Dist[Vertex] > Search.Dist[NextLandmark]) {
+                    NextLandmark = Vertex;
+                }
+            }
+        }
+        while (!LandmarksDone) {
+            if (std::chrono::steady_clock::now() >= deadline) {
+                return false;
+            }
+            Landmarks.push_back(NextLandmark);
+            SearchAll(NextLandmark, true);
+            StoreLandmarkDistances(ToLandmark, LandmarksReady);
+            SearchAll(NextLandmark, false);
+            StoreLandmarkDistances(FromLandmark, LandmarksReady);
+            LandmarksReady++;
+
+            for (TVertexID Vertex = 0; Vertex < NumVertices; Vertex++) {
+                LandmarkNearest[Vertex] = std::min(LandmarkNearest[Vertex], Search.Distance(Vertex));
+            }
+            NextLandmark = std::max_element(LandmarkNearest.begin(), LandmarkNearest.end()) - LandmarkNearest.begin();
+            // Stop early once every vertex is a landmark
+            LandmarksDone = LandmarksReady == std::min(LandmarkCount, NumVertices) || LandmarkNearest[NextLandmark] == 0;
+        }
+        return true;
+    }
+
+    // Triangle inequality bound on the distance from vertex to dest using the landmark tables.
+    // Entries are floats, so each term gives up a relative slack to stay below the true distance.
+    double LandmarkBound(TVertexID vertex, TVertexID dest) const {
+        const double Slack = 1e-6;
+        const float *FromVertex = &FromLandmark[vertex * LandmarkCount];
+        const float *FromDest = &FromLandmark[dest * LandmarkCount];
+        const float *ToVertex = &ToLandmark[vertex * LandmarkCount];
+        const float *ToDest = &ToLandmark[dest * LandmarkCount];
+        double Bound = 0;
+        for (std::size_t Index = 0; Index < LandmarksReady; Index++) {
+            // d(vertex, dest) >= d(landmark, dest) - d(landmark, vertex)
+            if (std::isfinite(FromVertex[Index]) && std::isfinite(FromDest[Index])) {
+                Bound = std::max(Bound, FromDest[Index] - double(FromVertex[Index]) - (FromDest[Index] + double(FromVertex[Index])) * Slack);
+            }
+            // d(vertex, dest) >= d(vertex, landmark) - d(dest, landmark)
+            if (std::isfinite(ToVertex[Index]) && std::isfinite(ToDest[Index])) {
+                Bound = std::max(Bound, ToVertex[Index] - double(ToDest[Index]) - (ToVertex[Index] + double(ToDest[Index])) * Slack);
+            }
+        }
+        return Bound;
+    }
 
-        // Check if the current time is past the deadline
-        while (std::chrono::steady_clock::now() < deadline) {
-            // std::cout << "Precomputing..." << std::endl;
+    double EstimateRemaining(TVertexID vertex, TVertexID dest) const {
+        double Estimate = Heuristic ? Heuristic(vertex, dest) : 0.0;
+        if (LandmarksReady) {
+            Estimate = std::max(Estimate, LandmarkBound(vertex, dest));
         }
+        return Estimate;
+    }
 
-        // Return true if precomputation was successful, false otherwise
+    // Returns as soon as the work is done, true if everything finished before the deadline
+    bool Precompute(std::chrono::steady_clock::time_point deadline) noexcept {
+        // Freeze the graph into its CSR form so queries do not have to
+        Finalize();
+        if (LandmarkCount) {
+            return PrecomputeLandmarks(deadline);
+        }
         return true;
     }
 
+    double PrecomputeProgress() const noexcept {
+        if (!Finalized) {
+            return 0.0;
+        }
+        if (!LandmarkCount || LandmarksDone) {
+            return 1.0;
+        }
+        return double(LandmarksReady) / std::min(LandmarkCount, VertexTags.size());
+    }
+
     double FindShortestPath(TVertexID src, TVertexID dest, std::vector<TVertexID> &path) noexcept {
-        // Initialize the distance map and parent vertex map
-        std::unordered_map<TVertexID, double> Dist;
-        std::unordered_map<TVertexID, TVertexID> ParentVertex; // Parent vertex helps reconstruct the path
-        
-        // Initialize the distance of all vertices to infinity and the parent vertex to -1
-        for (auto &Vertex : Graph) {
-            Dist[Vertex.first] = INF;
-            ParentVertex[Vertex.first] = -1;
-        }
-
-        // Define a priority queue with the custom comparator
-        std::priority_queue<TVertexID, std::vector<TVertexID>, CompareDist> PQ{CompareDist(Dist)};
-        
+        path.clear();
+        if (src >= VertexTags.size() || dest >= VertexTags.size()) {
+            return CPathRouter::NoPathExists;
+        }
+        Finalize();
+        if (Bidirectional) {
+            return FindShortestPathBidirectional(src, dest, path);
+        }
+
         // Set the distance of the source vertex to 0 and push it to the priority queue
-        Dist[src] = 0;
-        PQ.push(src);
-
-        // Perform Dijkstra's algorithm
-        while (!PQ.empty()) {
-            // Get the vertex with the smallest distance
-            TVertexID u = PQ.top();
-            // Remove the vertex from the priority queue
-            PQ.pop();
+        Search.Reset(VertexTags.size());
+        Search.Relax(src, 0, CPathRouter::InvalidVertexID);
+        Search.Heap.Update(src, 0);
+
+        // Perform Dijkstra's algorithm, or A* when a heuristic or landmarks are set
+        while (!Search.Heap.Empty()) {
+            // Get the vertex with the smallest key and remove it from the priority queue
+            TVertexID u = Search.Heap.TopItem();
+            double DistU = Search.Dist[u];
+            Search.Heap.Pop();
             
             // Break if the destination vertex is reached
             if (u == dest) {
@@ -115,42 +277,148 @@ struct CDijkstraPathRouter::SImplementation {
             }
 
             // Iterate over the adjacent vertices
-            // Graph[u].Edges is the adjacency list of vertex u
-            for (const auto& [v, weight] : Graph[u].Edges) {
+            // The CSR slice [Offsets[u], Offsets[u + 1]) is the adjacency list of vertex u
+            for (std::size_t EdgeIndex = Offsets[u]; EdgeIndex < Offsets[u + 1]; EdgeIndex++) {
+                auto v = Targets[EdgeIndex];
+                auto NewDist = DistU + Weights[EdgeIndex];
                 // If the distance to vertex v through u is shorter than the current distance to v
-                // Update the distance and parent vertex, and push v to the priority queue
-                if (Dist[u] + weight < Dist[v]) {
-                    Dist[v] = Dist[u] + weight;
-                    ParentVertex[v] = u;
-                    PQ.push(v); // Should automatically update the priority queue ordering
+                // Update the distance and parent vertex, and queue v or lower its key
+                if (NewDist < Search.Distance(v)) {
+                    if (!Search.Reached(v)) {
+                        Search.Estimate[v] = EstimateRemaining(v, dest);
+                    }
+                    Search.Relax(v, NewDist, u);
+                    // A vertex already popped is queued again, so an admissible but inconsistent heuristic stays exact
+                    Search.Heap.Update(v, NewDist + Search.Estimate[v]);
                 }
             }
-            // std::cout << "Current vertex: " << u << ", Distance: " << Dist[u] << std::endl;
         }
 
-        // Reconstruct the path
-        path.clear();
-        TVertexID CurrentVertex = dest;
-        
+        if (!Search.Reached(dest)) {
+            return CPathRouter::NoPathExists;
+        }
+
         // Traverse the parent vertices from the destination to the source
-        for (size_t i = 0; i < Graph.size(); i++) {
+        for (TVertexID CurrentVertex = dest; CurrentVertex != CPathRouter::InvalidVertexID; CurrentVertex = Search.ParentVertex[CurrentVertex]) {
             path.push_back(CurrentVertex);
-            CurrentVertex = ParentVertex[CurrentVertex]; // Update the current vertex to the parent vertex
-            if (CurrentVertex == -1) {
+        }
+        std::reverse(path.begin(), path.end()); // Reverse the path to get the correct order
+
+        // Return the distance to the destination vertex
+        return Search.Dist[dest];
+    }
+
+    // One Dijkstra search per source that stops once every destination is settled
+    void FindDistances(const std::vector<TVertexID> &srcs, const std::vector<TVertexID> &dests, std::vector<std::vector<double>> &distances) {
+        distances.assign(srcs.size(), std::vector<double>(dests.size(), CPathRouter::NoPathExists));
+        Finalize();
+        std::size_t NumVertices = VertexTags.size();
+        std::vector<bool> IsDestination(NumVertices, false);
+        std::size_t NumDestinations = 0;
+        for (auto Dest : dests) {
+            if (Dest < NumVertices && !IsDestination[Dest]) {
+                IsDestination[Dest] = true;
+                NumDestinations++;
+            }
+        }
+        for (std::size_t Row = 0; Row < srcs.size(); Row++) {
+            if (srcs[Row] >= NumVertices || !NumDestinations) {
+                continue;
+            }
+            Search.Reset(NumVertices);
+            Search.Relax(srcs[Row], 0, CPathRouter::InvalidVertexID);
+            Search.Heap.Update(srcs[Row], 0);
+            auto Remaining = NumDestinations;
+            while (!Search.Heap.Empty()) {
+                TVertexID u = Search.Heap.TopItem();
+                double DistU = Search.Dist[u];
+                Search.Heap.Pop();
+                if (IsDestination[u] && !--Remaining) {
+                    break;
+                }
+                for (std::size_t EdgeIndex = Offsets[u]; EdgeIndex < Offsets[u + 1]; EdgeIndex++) {
+                    auto v = Targets[EdgeIndex];
+                    auto NewDist = DistU + Weights[EdgeIndex];
+                    if (NewDist < Search.Distance(v)) {
+                        Search.Relax(v, NewDist, u);
+                        Search.Heap.Update(v, NewDist);
+                    }
+                }
+            }
+            // A destination still queued when the search stopped is unreachable, every other was settled
+            for (std::size_t Column = 0; Column < dests.size(); Column++) {
+                if (dests[Column] < NumVertices && Search.Reached(dests[Column])) {
+                    distances[Row][Column] = Search.Dist[dests[Column]];
+                }
+            }
+        }
+    }
+
+    double FindShortestPathBidirectional(TVertexID src, TVertexID dest, std::vector<TVertexID> &path) {
+        Search.Reset(VertexTags.size());
+        BackwardSearch.Reset(VertexTags.size());
+        Search.Relax(src, 0, CPathRouter::InvalidVertexID);
+        Search.Heap.Update(src, 0);
+        BackwardSearch.Relax(dest, 0, CPathRouter::InvalidVertexID);
+        BackwardSearch.Heap.Update(dest, 0);
+
+        // Best known src to dest distance and the vertex where the two searches met on it
+        double BestDist = std::numeric_limits<double>::infinity();
+        TVertexID MeetVertex = CPathRouter::InvalidVertexID;
+        if (src == dest) {
+            BestDist = 0;
+            MeetVertex = src;
+        }
+
+        while (!Search.Heap.Empty() && !BackwardSearch.Heap.Empty()) {
+            // Nothing left in either queue can improve on a path through the meeting vertex
+            if (Search.Heap.TopKey() + BackwardSearch.Heap.TopKey() >= BestDist) {
                 break;
             }
+            // Expand the smaller frontier, backward steps walk the reverse adjacency
+            bool Forward = Search.Heap.Size() <= BackwardSearch.Heap.Size();
+            auto &Active = Forward ? Search : BackwardSearch;
+            auto &Opposite = Forward ? BackwardSearch : Search;
+            const auto &ActiveOffsets = Forward ? Offsets : ReverseOffsets;
+            const auto &ActiveVertices = Forward ? Targets : ReverseSources;
+            const auto &ActiveWeights = Forward ? Weights : ReverseWeights;
+
+            TVertexID u = Active.Heap.TopItem();
+            double DistU = Active.Dist[u];
+            Active.Heap.Pop();
+            for (std::size_t EdgeIndex = ActiveOffsets[u]; EdgeIndex < ActiveOffsets[u + 1]; EdgeIndex++) {
+                auto v = ActiveVertices[EdgeIndex];
+                auto NewDist = DistU + ActiveWeights[EdgeIndex];
+                if (NewDist < Active.Distance(v)) {
+                    Active.Relax(v, NewDist, u);
+                    Active.Heap.Update(v, NewDist);
+                    if (Opposite.Reached(v) && NewDist + Opposite.Dist[v] < BestDist) {
+                        BestDist = NewDist + Opposite.Dist[v];
+                        MeetVertex = v;
+                    }
+                }
+            }
         }
-        std::reverse(path.begin(), path.end()); // Reverse the path to get the correct order
 
-        if (path.empty()) {
-            path.clear();
-            return CPathRouter::NoPathExists;
-        } else if (path[0] != src || path.back() != dest) {
-            path.clear();
+        if (MeetVertex == CPathRouter::InvalidVertexID) {
             return CPathRouter::NoPathExists;
         }
-        // Return the distance to the destination vertex
-        return Dist[dest];
+
+        // The forward tree gives src..MeetVertex, the backward tree continues on to dest
+        for (TVertexID CurrentVertex = MeetVertex; CurrentVertex != CPathRouter::InvalidVertexID; CurrentVertex = Search.ParentVertex[CurrentVertex]) {
+            path.push_back(CurrentVertex);
+        }
+        std::reverse(path.begin(), path.end());
+        for (TVertexID CurrentVertex = BackwardSearch.ParentVertex[MeetVertex]; CurrentVertex != CPathRouter::InvalidVertexID; CurrentVertex = BackwardSearch.ParentVertex[CurrentVertex]) {
+            path.push_back(CurrentVertex);
+        }
+
+        // Sum the edges from src to dest so the result matches a forward search bit for bit
+        double PathDist = 0;
+        for (std::size_t Index = 1; Index < path.size(); Index++) {
+            PathDist += EdgeWeight(path[Index - 1], path[Index]);
+        }
+        return PathDist;
     }
 };
             
@@ -163,7 +431,7 @@ CDijkstraPathRouter::CDijkstraPathRouter() {
 CDijkstraPathRouter::~CDijkstraPathRouter() = default;
 
 std::size_t CDijkstraPathRouter::VertexCount() const noexcept {
-    return DImplementation->Graph.size();
+    return DImplementation->VertexTags.size();
 }
 
 CDijkstraPathRouter::TVertexID CDijkstraPathRouter::AddVertex(std::any tag) noexcept {
@@ -184,4 +452,30 @@ bool CDijkstraPathRouter::Precompute(std::chrono::steady_clock::time_point deadl
 
 double CDijkstraPathRouter::FindShortestPath(TVertexID src, TVertexID dest, std::vector<TVertexID> &path) noexcept {
     return DImplementation->FindShortestPath(src, dest, path);
-}
\ No newline at end of file
+}
+
+void CDijkstraPathRouter::FindDistances(const std::vector<TVertexID> &srcs, const std::vector<TVertexID> &dests, std::vector<std::vector<double>> &distances) noexcept {
+    DImplementation->FindDistances(srcs, dests, distances);
+}
+
+void CDijkstraPathRouter::SetHeuristic(THeuristic heuristic) noexcept {
+    DImplementation->Heuristic = heuristic;
+}
+
+void CDijkstraPathRouter::SetBidirectional(bool bidirectional) noexcept {
+    DImplementation->Bidirectional = bidirectional;
+}
+
+void CDijkstraPathRouter::SetLandmarkCount(std::size_t count) noexcept {
+    DImplementation->LandmarkCount = count;
+    DImplementation->ResetLandmarks();
+}
+
+double CDijkstraPathRouter::PrecomputeProgress() const noexcept {
+    return DImplementation->PrecomputeProgress();
+}
+
+std::vector<CPathRouter::TVertexID> CDijkstraPathRouter::Landmarks() const noexcept {
+    auto &Implementation = *DImplementation;
+    return std::vector<TVertexID>(Implementation.Landmarks.begin(), Implementation.Landmarks.begin() + Implementation.LandmarksReady);
+}
@@ -1,11 +1,16 @@
 #include "DijkstraTransportationPlanner.h"
 #include "DijkstraPathRouter.h"
+#include "ContractionHierarchyPathRouter.h"
 #include "BusSystemIndexer.h"
 #include "GeographicUtils.h"
 #include "StreetMap.h"
+#include "StringUtils.h"
+#include "BinaryIO.h"
+#include "RaptorTransitRouter.h"
+#include "StreetMapNodeIndex.h"
 #include <unordered_map>
+#include <unordered_set>
 #include <set>
-#include <map>
 #include <vector>
 #include <memory>
 #include <algorithm>
@@ -13,6 +18,86 @@
 #include <sstream>
 #include <iomanip>
 #include <string>
+#include <chrono>
+#include <charconv>
+#include <cctype>
+#include <cstdint>
+#include <cmath>
+
+// Bus system as the planner sees it, stops whose node is on no way are moved to the nearest
+// node that is so buses can stop there and walks can reach them. The node index must only hold
+// routable nodes.
+class CSnappedBusSystem : public CBusSystem {
+    private:
+        struct SSnappedStop : public CBusSystem::SStop {
+            TStopID DID;
+            CStreetMap::TNodeID DNodeID;
+
+            SSnappedStop(TStopID id, CStreetMap::TNodeID nodeid) : DID(id), DNodeID(nodeid) {}
+
+            TStopID ID() const noexcept override {
+                return DID;
+            }
+
+            CStreetMap::TNodeID NodeID() const noexcept override {
+                return DNodeID;
+            }
+        };
+
+        std::shared_ptr<CBusSystem> DBusSystem;
+        std::vector<std::shared_ptr<SStop>> DStops;
+        std::unordered_map<TStopID, std::shared_ptr<SStop>> DStopsByID;
+        // Node each moved stop was on to the node it was moved to
+        std::unordered_map<CStreetMap::TNodeID, CStreetMap::TNodeID> DMovedNodes;
+
+    public:
+        CSnappedBusSystem(std::shared_ptr<CBusSystem> bussystem, std::shared_ptr<CStreetMap> streetmap, const CStreetMapNodeIndex &nodeindex) : DBusSystem(bussystem) {
+            for (std::size_t Index = 0; Index < bussystem->StopCount(); Index++) {
+                auto Stop = bussystem->StopByIndex(Index);
+                auto NodeID = Stop->NodeID();
+                // A stop on a node the map does not have has no location to snap from
+                auto Node = streetmap->NodeByID(NodeID);
+                if (Node && !nodeindex.Contains(NodeID)) {
+                    auto NearestNodeID = nodeindex.NearestNode(Node->Location());
+                    if (NearestNodeID != CStreetMap::InvalidNodeID) {
+                        DMovedNodes[NodeID] = NearestNodeID;
+                        NodeID = NearestNodeID;
+                    }
+                }
+                DStops.push_back(std::make_shared<SSnappedStop>(Stop->ID(), NodeID));
+                DStopsByID.emplace(Stop->ID(), DStops.back());
+            }
+        }
+
+        std::size_t StopCount() const noexcept override {
+            return DStops.size();
+        }
+
+        const std::unordered_map<CStreetMap::TNodeID, CStreetMap::TNodeID>& MovedNodes() const noexcept {
+            return DMovedNodes;
+        }
+
+        std::size_t RouteCount() const noexcept override {
+            return DBusSystem->RouteCount();
+        }
+
+        std::shared_ptr<SStop> StopByIndex(std::size_t index) const noexcept override {
+            return index < DStops.size() ? DStops[index] : nullptr;
+        }
+
+        std::shared_ptr<SStop> StopByID(TStopID id) const noexcept override {
+            auto Search = DStopsByID.find(id);
+            return Search == DStopsByID.end() ? nullptr : Search->second;
+        }
+
+        std::shared_ptr<SRoute> RouteByIndex(std::size_t index) const noexcept override {
+            return DBusSystem->RouteByIndex(index);
+        }
+
+        std::shared_ptr<SRoute> RouteByName(const std::string &name) const noexcept override {
+            return DBusSystem->RouteByName(name);
+        }
+};
 
 // Define the SImplementation struct
 struct CDijkstraTransportationPlanner::SImplementation {
@@ -20,14 +105,53 @@ struct CDijkstraTransportationPlanner::SImplementation {
     std::unordered_map<CStreetMap::TNodeID, CPathRouter::TVertexID> NodeToVertex;
     std::unordered_map<CPathRouter::TVertexID, CStreetMap::TNodeID> VertexToNode;
     std::vector<CStreetMap::TNodeID> SortedNodeIDs;
-    std::map<std::pair<CStreetMap::TNodeID, CStreetMap::TNodeID>, CStreetMap::TWayID> NodePairToWay;
+    // Way of each pair of consecutive way nodes, in both directions
+    std::unordered_map<std::pair<CStreetMap::TNodeID, CStreetMap::TNodeID>, CStreetMap::TWayID, CBusSystemIndexer::SNodePairHash> SegmentToWay;
+    // Indexes (in the street map) of the ways through each node
+    std::unordered_map<CStreetMap::TNodeID, std::vector<std::size_t>> WayIndexesByNode;
     std::shared_ptr<CStreetMap> DStreetMap;
+    // Nearest routable node lookups, also used to snap stops onto the street network
+    std::shared_ptr<CStreetMapNodeIndex> DNodeIndex;
+    std::shared_ptr<CBusSystem> DBusSystem;
     std::shared_ptr<CBusSystemIndexer> DBusSystemIndexer;
+    // Timetable for scheduled trips with the street node of each stop it serves
+    std::shared_ptr<CRaptorTransitRouter> DSchedule;
+    std::vector<std::pair<CBusSystem::TStopID, CStreetMap::TNodeID>> ScheduleStops;
+    // Straight line limits (in miles) on the walks to, from and between scheduled stops
+    static constexpr double MaxAccessDistance = 0.5;
+    static constexpr double MaxTransferDistance = 0.25;
+    // Routing graphs are built once at construction and shared by every query
+    std::shared_ptr<CContractionHierarchyPathRouter> DShortestPathRouter;
+    // The fastest path graph has one layer of vertices per mode, plus origin and destination layers
+    // whose vertices only lead into (or out of) the walk and bike layers. Searching from a node's
+    // origin vertex to a node's destination vertex picks the best mode, and a trip started on foot
+    // can board and leave buses through zero cost transfers but never switch to a bike.
+    enum class EFastestPathLayer {Walk = 0, Bike, Bus, Origin, Destination, Count};
+    std::shared_ptr<CContractionHierarchyPathRouter> DFastestPathRouter;
+    // Street graph in miles that ignores one way tags, for the walks of scheduled trips. Walks in
+    // the fastest path graph are not used since a search there may also ride the bus layer.
+    std::shared_ptr<CContractionHierarchyPathRouter> DWalkPathRouter;
+    // Routing tags of a way, decoded once so graph builders never look up or parse strings
+    struct SWayProfile {
+        double SpeedLimit; // mph, the configured default when the way has no usable maxspeed
+        bool OneWay : 1;
+        bool BikeAllowed : 1;
+    };
+    // Indexed like the street map's ways
+    std::vector<SWayProfile> WayProfiles;
     double DWalkSpeed;
     double DBikeSpeed;
     double DDefaultSpeedLimit;
     double DBusStopTime;
     int DPrecomputeTime;
+    // Share of the precompute time spent building and contracting, the rest is a safety margin
+    // for a slice that overruns, the timer granularity and whatever the caller does after loading
+    static constexpr double PrecomputeBudgetFraction = 0.8;
+    // Hash of everything the routing graphs are built from, saved artifacts only load if it matches
+    uint64_t DInputHash;
+    bool DArtifactsLoaded = false;
+    static constexpr uint32_t ArtifactMagic = 0x41505444; // "DTPA"
+    static constexpr uint32_t ArtifactVersion = 2;
 
     std::string DoubleToStringWithOneDecimal(double value) const {
         std::ostringstream oss;
@@ -55,33 +179,193 @@ struct CDijkstraTransportationPlanner::SImplementation {
         return;
     }
 
+    // Reads a maxspeed value such as "25", "25 mph" or "40 km/h" in mph. Plain numbers are taken
+    // as mph like the rest of the map data, values like "none" or "signals" give the default.
+    static double ParseSpeedLimit(const std::string &value, double defaultSpeed) {
+        const char *Begin = value.data();
+        const char *End = value.data() + value.size();
+        while (Begin < End && std::isspace(static_cast<unsigned char>(*Begin))) {
+            Begin++;
+        }
+        double Speed;
+        auto Result = std::from_chars(Begin, End, Speed);
+        if (Result.ec != std::errc() || Speed <= 0) {
+            return defaultSpeed;
+        }
+        auto Unit = StringUtils::Lower(StringUtils::Strip(std::string(Result.ptr, End)));
+        if (Unit.empty() || Unit == "mph") {
+            return Speed;
+        }
+        if (Unit == "km/h" || Unit == "kmh" || Unit == "kph") {
+            return Speed / 1.609344;
+        }
+        return defaultSpeed;
+    }
+
+    void ReadWayProfiles() {
+        std::size_t NumWays = DStreetMap->WayCount();
+        WayProfiles.resize(NumWays);
+        for (std::size_t Index = 0; Index < NumWays; Index++) {
+            auto Way = DStreetMap->WayByIndex(Index);
+            auto &Profile = WayProfiles[Index];
+            Profile.SpeedLimit = ParseSpeedLimit(Way->GetAttribute("maxspeed"), DDefaultSpeedLimit);
+            // OSM spells a forward one way street yes, true or 1
+            auto OneWay = Way->GetAttribute("oneway");
+            Profile.OneWay = OneWay == "yes" || OneWay == "true" || OneWay == "1";
+            Profile.BikeAllowed = Way->GetAttribute("bicycle") != "no";
+        }
+    }
+
+    // Linear in the total way length, later ways win when two share a segment
     void StoreWays(){
         std::size_t NumWays = DStreetMap->WayCount();
         for (std::size_t Index = 0; Index < NumWays; Index++) {
             auto Way = DStreetMap->WayByIndex(Index);
             std::size_t NumNodes = Way->NodeCount();
-            for (std::size_t NodeIndex1 = 0; NodeIndex1 < NumNodes; NodeIndex1++) {
-                for (std::size_t NodeIndex2 = NodeIndex1 + 1; NodeIndex2 < NumNodes; NodeIndex2++) {
-                    auto Node1 = Way->GetNodeID(NodeIndex1);
-                    auto Node2 = Way->GetNodeID(NodeIndex2);
-                    NodePairToWay[std::make_pair(Node1, Node2)] = Way->ID();
-                    NodePairToWay[std::make_pair(Node2, Node1)] = Way->ID();
+            for (std::size_t NodeIndex = 0; NodeIndex < NumNodes; NodeIndex++) {
+                auto Node = Way->GetNodeID(NodeIndex);
+                auto &WayIndexes = WayIndexesByNode[Node];
+                if (WayIndexes.empty() || WayIndexes.back() != Index) {
+                    WayIndexes.push_back(Index);
+                }
+                if (NodeIndex > 0) {
+                    auto PrevNode = Way->GetNodeID(NodeIndex - 1);
+                    SegmentToWay[std::make_pair(PrevNode, Node)] = Way->ID();
+                    SegmentToWay[std::make_pair(Node, PrevNode)] = Way->ID();
+                }
+            }
+        }
+    }
+
+    // Way that connects two nodes. Consecutive nodes are a single lookup, other pairs (a bus step
+    // can skip over nodes) check the ways through the first node, latest way first, and then the
+    // way a loaded bus segment path leaves on.
+    CStreetMap::TWayID FindWay(CStreetMap::TNodeID node1, CStreetMap::TNodeID node2) const {
+        auto Segment = SegmentToWay.find(std::make_pair(node1, node2));
+        if (Segment != SegmentToWay.end()) {
+            return Segment->second;
+        }
+        auto WayIndexes = WayIndexesByNode.find(node1);
+        if (WayIndexes == WayIndexesByNode.end()) {
+            return CStreetMap::InvalidWayID;
+        }
+        for (auto WayIndex = WayIndexes->second.rbegin(); WayIndex != WayIndexes->second.rend(); WayIndex++) {
+            auto Way = DStreetMap->WayByIndex(*WayIndex);
+            for (std::size_t NodeIndex = 0; NodeIndex < Way->NodeCount(); NodeIndex++) {
+                if (Way->GetNodeID(NodeIndex) == node2) {
+                    return Way->ID();
                 }
             }
         }
+        auto SegmentPath = DBusSystemIndexer->SegmentPathByNodeIDs(node1, node2);
+        if (SegmentPath && SegmentPath->DNodeIDs.size() > 1) {
+            Segment = SegmentToWay.find(std::make_pair(SegmentPath->DNodeIDs[0], SegmentPath->DNodeIDs[1]));
+            if (Segment != SegmentToWay.end()) {
+                return Segment->second;
+            }
+        }
+        return CStreetMap::InvalidWayID;
     }
 
-    SImplementation(std::shared_ptr<SConfiguration> config) {
+    SImplementation(std::shared_ptr<SConfiguration> config, std::shared_ptr<CDataSource> artifacts, std::shared_ptr<CDSVReader> buspaths) {
+        // Building and preprocessing the graphs all counts against the precompute time
+        auto PrecomputeBudget = std::chrono::milliseconds(static_cast<int64_t>(config->PrecomputeTime() * 1000 * PrecomputeBudgetFraction));
+        auto PrecomputeDeadline = std::chrono::steady_clock::now() + PrecomputeBudget;
         // Get the configuration parameters
         DStreetMap = config->StreetMap();
-        DBusSystemIndexer = std::make_shared<CBusSystemIndexer>(config->BusSystem());
+        DNodeIndex = std::make_shared<CStreetMapNodeIndex>(DStreetMap);
+        auto SnappedBusSystem = std::make_shared<CSnappedBusSystem>(config->BusSystem(), DStreetMap, *DNodeIndex);
+        DBusSystem = SnappedBusSystem;
+        DBusSystemIndexer = buspaths ? std::make_shared<CBusSystemIndexer>(DBusSystem, buspaths, DStreetMap, SnappedBusSystem->MovedNodes()) : std::make_shared<CBusSystemIndexer>(DBusSystem);
         DWalkSpeed = config->WalkSpeed();
         DBikeSpeed = config->BikeSpeed();
         DDefaultSpeedLimit = config->DefaultSpeedLimit();
         DBusStopTime = config->BusStopTime();
         DPrecomputeTime = config->PrecomputeTime();
         ReadSortNodeIDs();
+        ReadWayProfiles();
         StoreWays();
+        BuildRouters();
+        DInputHash = InputHash();
+        if (artifacts) {
+            DArtifactsLoaded = LoadArtifacts(artifacts);
+        }
+        PrecomputeRouters(PrecomputeDeadline);
+    }
+
+    uint64_t InputHash() const {
+        auto Hash = BinaryIO::Hash(&ArtifactVersion, sizeof(ArtifactVersion));
+        auto HashValue = [&Hash](const auto &value) {
+            Hash = BinaryIO::Hash(&value, sizeof(value), Hash);
+        };
+        auto HashString = [&Hash, &HashValue](const std::string &str) {
+            HashValue(str.size());
+            Hash = BinaryIO::Hash(str.data(), str.size(), Hash);
+        };
+        HashValue(DWalkSpeed);
+        HashValue(DBikeSpeed);
+        HashValue(DDefaultSpeedLimit);
+        HashValue(DBusStopTime);
+        for (std::size_t Index = 0; Index < DStreetMap->NodeCount(); Index++) {
+            auto Node = DStreetMap->NodeByIndex(Index);
+            HashValue(Node->ID());
+            HashValue(Node->Location());
+        }
+        for (std::size_t Index = 0; Index < DStreetMap->WayCount(); Index++) {
+            auto Way = DStreetMap->WayByIndex(Index);
+            HashValue(Way->ID());
+            for (std::size_t NodeIndex = 0; NodeIndex < Way->NodeCount(); NodeIndex++) {
+                HashValue(Way->GetNodeID(NodeIndex));
+            }
+            for (std::size_t AttributeIndex = 0; AttributeIndex < Way->AttributeCount(); AttributeIndex++) {
+                auto Key = Way->GetAttributeKey(AttributeIndex);
+                HashString(Key);
+                HashString(Way->GetAttribute(Key));
+            }
+        }
+        for (std::size_t Index = 0; Index < DBusSystem->StopCount(); Index++) {
+            auto Stop = DBusSystem->StopByIndex(Index);
+            HashValue(Stop->ID());
+            HashValue(Stop->NodeID());
+        }
+        for (std::size_t Index = 0; Index < DBusSystem->RouteCount(); Index++) {
+            auto Route = DBusSystem->RouteByIndex(Index);
+            HashString(Route->Name());
+            for (std::size_t StopIndex = 0; StopIndex < Route->StopCount(); StopIndex++) {
+                HashValue(Route->GetStopID(StopIndex));
+            }
+        }
+        for (std::size_t Index = 0; Index < DBusSystemIndexer->SegmentPathCount(); Index++) {
+            auto SegmentPath = DBusSystemIndexer->SegmentPathByIndex(Index);
+            HashValue(SegmentPath->DNodeIDs.size());
+            Hash = BinaryIO::Hash(SegmentPath->DNodeIDs.data(), SegmentPath->DNodeIDs.size() * sizeof(CStreetMap::TNodeID), Hash);
+        }
+        return Hash;
+    }
+
+    // Restores the router hierarchies in place of contracting them. The graphs and node tables
+    // are still built from the inputs, that takes a small fraction of the contraction time.
+    bool LoadArtifacts(std::shared_ptr<CDataSource> source) {
+        uint32_t Magic, Version;
+        uint64_t Hash;
+        if (!BinaryIO::Read(*source, Magic) || Magic != ArtifactMagic || !BinaryIO::Read(*source, Version) || Version != ArtifactVersion) {
+            return false;
+        }
+        if (!BinaryIO::Read(*source, Hash) || Hash != DInputHash) {
+            return false;
+        }
+        return DShortestPathRouter->LoadHierarchy(source) && DFastestPathRouter->LoadHierarchy(source) && DWalkPathRouter->LoadHierarchy(source);
+    }
+
+    bool SaveArtifacts(std::shared_ptr<CDataSink> sink) const {
+        if (!sink || !DShortestPathRouter->Contracted() || !DFastestPathRouter->Contracted() || !DWalkPathRouter->Contracted()) {
+            return false;
+        }
+        std::vector<char> Header;
+        BinaryIO::Append(Header, ArtifactMagic);
+        BinaryIO::Append(Header, ArtifactVersion);
+        BinaryIO::Append(Header, DInputHash);
+        return sink->Write(Header) && DShortestPathRouter->SaveHierarchy(sink) && DFastestPathRouter->SaveHierarchy(sink) && DWalkPathRouter->SaveHierarchy(sink);
     }
 
     std::size_t NodeCount() const noexcept {
@@ -96,24 +380,74 @@ struct CDijkstraTransportationPlanner::SImplementation {
         return DStreetMap->NodeByID(NodeID);            
     }
 
-    void CreateStreetNodes(std::shared_ptr<CDijkstraPathRouter> pathRouter) {
+    void CreateStreetNodes(std::shared_ptr<CPathRouter> pathRouter) {
         for (auto NodeID : SortedNodeIDs) {
             auto VertexID = pathRouter->AddVertex(NodeID);
             NodeToVertex[NodeID] = VertexID;
             VertexToNode[VertexID] = NodeID;
         }
-    }                
+    }
+
+    void BuildRouters() {
+        // Every router adds the street nodes in the same sorted order, so they all share NodeToVertex
+        DShortestPathRouter = std::make_shared<CContractionHierarchyPathRouter>();
+        CreateStreetNodes(DShortestPathRouter);
+        CreateShortestPathEdges(DShortestPathRouter, true);
+
+        DFastestPathRouter = std::make_shared<CContractionHierarchyPathRouter>();
+        for (int Layer = 0; Layer < int(EFastestPathLayer::Count); Layer++) {
+            for (auto NodeID : SortedNodeIDs) {
+                DFastestPathRouter->AddVertex(NodeID);
+            }
+        }
+        CreateFastestPathEdgesBusWalk(DFastestPathRouter);
+        CreateFastestPathBikingEdges(DFastestPathRouter);
+        CreateFastestPathEndpointEdges(DFastestPathRouter);
+
+        DWalkPathRouter = std::make_shared<CContractionHierarchyPathRouter>();
+        for (auto NodeID : SortedNodeIDs) {
+            DWalkPathRouter->AddVertex(NodeID);
+        }
+        CreateShortestPathEdges(DWalkPathRouter, false);
+    }
+
+    CPathRouter::TVertexID FastestPathVertex(EFastestPathLayer layer, CPathRouter::TVertexID streetVertex) const {
+        return std::size_t(layer) * SortedNodeIDs.size() + streetVertex;
+    }
+
+    EFastestPathLayer FastestPathLayer(CPathRouter::TVertexID vertex) const {
+        return EFastestPathLayer(vertex / SortedNodeIDs.size());
+    }
+
+    // Street vertex in the shortest path graph (and NodeToVertex) of a fastest path vertex
+    CPathRouter::TVertexID FastestPathStreetVertex(CPathRouter::TVertexID vertex) const {
+        return vertex % SortedNodeIDs.size();
+    }
+
+    // Contracts the graphs in turns of a short time slice, so a large graph cannot starve the
+    // others of the budget. Returns as soon as all are done, a router that does not finish by
+    // the deadline keeps answering queries without its hierarchy.
+    void PrecomputeRouters(std::chrono::steady_clock::time_point deadline) {
+        const auto TimeSlice = std::chrono::milliseconds(50);
+        std::vector<std::shared_ptr<CContractionHierarchyPathRouter>> Pending = {DShortestPathRouter, DFastestPathRouter, DWalkPathRouter};
+        while (!Pending.empty() && std::chrono::steady_clock::now() < deadline) {
+            for (auto &Router : Pending) {
+                Router->Precompute(std::min(deadline, std::chrono::steady_clock::now() + TimeSlice));
+            }
+            Pending.erase(std::remove_if(Pending.begin(), Pending.end(), [](const auto &router) {
+                return router->Contracted();
+            }), Pending.end());
+        }
+    }
     
-    void CreateShortestPathEdges(std::shared_ptr<CDijkstraPathRouter> pathRouter){
+    // Edges in miles along every way, one way streets only go forward with followOneWay
+    void CreateShortestPathEdges(std::shared_ptr<CPathRouter> pathRouter, bool followOneWay){
         std::size_t NumWays = DStreetMap->WayCount();
         for (std::size_t Index = 0; Index < NumWays; Index++) {
             auto Way = DStreetMap->WayByIndex(Index);
             std::size_t NumNodes = Way->NodeCount();
             
-            bool oneWay = false;
-            if (Way->GetAttribute("oneway") == "yes") {
-                oneWay = true;
-            }
+            bool oneWay = followOneWay && WayProfiles[Index].OneWay;
 
             for (std::size_t NodeIndex = 0; NodeIndex < NumNodes - 1; NodeIndex++) {
                 auto Node1 = Way->GetNodeID(NodeIndex); // This returns an ID, not the node itself
@@ -141,28 +475,44 @@ struct CDijkstraTransportationPlanner::SImplementation {
     }
 
     double FindShortestPath(CStreetMap::TNodeID src, CStreetMap::TNodeID dest, std::vector<CStreetMap::TNodeID>& path) {
-        auto ShortestPathRouter = std::make_shared<CDijkstraPathRouter>();
-        CreateStreetNodes(ShortestPathRouter);
-        CreateShortestPathEdges(ShortestPathRouter);
-        std::vector<CStreetMap::TNodeID> tempPath;
-        auto pathDist = ShortestPathRouter->FindShortestPath(NodeToVertex[src], NodeToVertex[dest], tempPath);
         path.clear();
+        auto SrcVertex = NodeToVertex.find(src);
+        auto DestVertex = NodeToVertex.find(dest);
+        if (SrcVertex == NodeToVertex.end() || DestVertex == NodeToVertex.end()) {
+            return CPathRouter::NoPathExists;
+        }
+        std::vector<CPathRouter::TVertexID> tempPath;
+        auto pathDist = DShortestPathRouter->FindShortestPath(SrcVertex->second, DestVertex->second, tempPath);
         for (auto Vertex : tempPath) {
             path.push_back(VertexToNode[Vertex]);
         }
         return pathDist;
     }
 
-    void CreateFastestPathEdgesBusWalk(std::shared_ptr<CDijkstraPathRouter> pathRouter){
+    // Time in hours for a bus to follow a street path at the speed limit of each way it is on
+    double BusPathTime(const std::vector<CStreetMap::TNodeID>& path, const std::unordered_map<CStreetMap::TWayID, std::size_t>& wayIndexes) const {
+        double Time = 0.0;
+        for (std::size_t Index = 1; Index < path.size(); Index++) {
+            auto SpeedLimit = DDefaultSpeedLimit;
+            auto Segment = SegmentToWay.find(std::make_pair(path[Index - 1], path[Index]));
+            if (Segment != SegmentToWay.end()) {
+                SpeedLimit = WayProfiles[wayIndexes.at(Segment->second)].SpeedLimit;
+            }
+            Time += SGeographicUtils::HaversineDistanceInMiles(DStreetMap->NodeByID(path[Index - 1])->Location(), DStreetMap->NodeByID(path[Index])->Location()) / SpeedLimit;
+        }
+        return Time;
+    }
+
+    // Each pair of consecutive stops of a route with a loaded path gets one bus edge timed along the
+    // path. Buses ride every street segment between other pairs of consecutive stops.
+    void CreateFastestPathEdgesBusWalk(std::shared_ptr<CPathRouter> pathRouter){
+        std::vector<bool> HasBusVertex(SortedNodeIDs.size(), false);
         std::size_t NumWays = DStreetMap->WayCount();
         for (std::size_t Index = 0; Index < NumWays; Index++) {
             auto Way = DStreetMap->WayByIndex(Index);
             std::size_t NumNodes = Way->NodeCount();
             
-            auto SpeedLimit = DDefaultSpeedLimit;
-            if (Way->GetAttribute("maxspeed") != "") {
-                SpeedLimit = std::stod(Way->GetAttribute("maxspeed"));
-            }
+            auto SpeedLimit = WayProfiles[Index].SpeedLimit;
 
             for (std::size_t NodeIndex = 0; NodeIndex < NumNodes - 1; NodeIndex++) {
                 auto Node1 = Way->GetNodeID(NodeIndex); // This returns an ID, not the node itself
@@ -177,31 +527,54 @@ struct CDijkstraTransportationPlanner::SImplementation {
                     auto Node2Location = DStreetMap->NodeByID(Node2)->Location();
                     auto Distance = SGeographicUtils::HaversineDistanceInMiles(Node1Location, Node2Location);
                     auto WalkEdgeWeight = Distance / DWalkSpeed;
-                    pathRouter->AddEdge(Node1Vertex->second, Node2Vertex->second, WalkEdgeWeight, true);
+                    pathRouter->AddEdge(FastestPathVertex(EFastestPathLayer::Walk, Node1Vertex->second), FastestPathVertex(EFastestPathLayer::Walk, Node2Vertex->second), WalkEdgeWeight, true);
 
-                    if (DBusSystemIndexer->RouteBetweenNodeIDs(Node1, Node2)) {
+                    if (DBusSystemIndexer->RouteBetweenNodeIDs(Node1, Node2) && !DBusSystemIndexer->SegmentPathByNodeIDs(Node1, Node2)) {
                         auto BusEdgeWeight = (Distance / SpeedLimit) + (DBusStopTime / 3600);
-                        pathRouter->AddEdge(Node1Vertex->second, Node2Vertex->second, BusEdgeWeight, false);
+                        pathRouter->AddEdge(FastestPathVertex(EFastestPathLayer::Bus, Node1Vertex->second), FastestPathVertex(EFastestPathLayer::Bus, Node2Vertex->second), BusEdgeWeight, false);
+                        HasBusVertex[Node1Vertex->second] = true;
+                        HasBusVertex[Node2Vertex->second] = true;
                     }
                 }
             }
         }
+        if (DBusSystemIndexer->SegmentPathCount() > 0) {
+            std::unordered_map<CStreetMap::TWayID, std::size_t> WayIndexes;
+            for (std::size_t Index = 0; Index < NumWays; Index++) {
+                WayIndexes[DStreetMap->WayByIndex(Index)->ID()] = Index;
+            }
+            for (std::size_t Index = 0; Index < DBusSystemIndexer->SegmentPathCount(); Index++) {
+                auto SegmentPath = DBusSystemIndexer->SegmentPathByIndex(Index);
+                auto SourceVertex = NodeToVertex.find(SegmentPath->DSource);
+                auto DestinationVertex = NodeToVertex.find(SegmentPath->DDestination);
+                if (SourceVertex == NodeToVertex.end() || DestinationVertex == NodeToVertex.end()) {
+                    continue;
+                }
+                auto BusEdgeWeight = BusPathTime(SegmentPath->DNodeIDs, WayIndexes) + (DBusStopTime / 3600);
+                pathRouter->AddEdge(FastestPathVertex(EFastestPathLayer::Bus, SourceVertex->second), FastestPathVertex(EFastestPathLayer::Bus, DestinationVertex->second), BusEdgeWeight, false);
+                HasBusVertex[SourceVertex->second] = true;
+                HasBusVertex[DestinationVertex->second] = true;
+            }
+        }
+        // Boarding and leaving a bus is free, the stop time is already part of each bus edge
+        for (CPathRouter::TVertexID Vertex = 0; Vertex < HasBusVertex.size(); Vertex++) {
+            if (HasBusVertex[Vertex]) {
+                pathRouter->AddEdge(FastestPathVertex(EFastestPathLayer::Walk, Vertex), FastestPathVertex(EFastestPathLayer::Bus, Vertex), 0.0, true);
+            }
+        }
     }
 
-    void CreateFastestPathBikingEdges(std::shared_ptr<CDijkstraPathRouter> pathRouter){
+    void CreateFastestPathBikingEdges(std::shared_ptr<CPathRouter> pathRouter){
         std::size_t NumWays = DStreetMap->WayCount();
         for (std::size_t Index = 0; Index < NumWays; Index++) {
             auto Way = DStreetMap->WayByIndex(Index);
             std::size_t NumNodes = Way->NodeCount();
 
-            if (Way->GetAttribute("bicyle") == "no") {
+            if (!WayProfiles[Index].BikeAllowed) {
                 continue;
             }
 
-            bool oneWay = false;
-            if (Way->GetAttribute("oneway") == "yes") {
-                oneWay = true;
-            }
+            bool oneWay = WayProfiles[Index].OneWay;
             
             for (std::size_t NodeIndex = 0; NodeIndex < NumNodes - 1; NodeIndex++) {
                 auto Node1 = Way->GetNodeID(NodeIndex); // This returns an ID, not the node itself
@@ -216,11 +589,13 @@ struct CDijkstraTransportationPlanner::SImplementation {
                     auto Node2Location = DStreetMap->NodeByID(Node2)->Location();
                     auto EdgeWeight = SGeographicUtils::HaversineDistanceInMiles(Node1Location, Node2Location);
                     EdgeWeight /= DBikeSpeed;
+                    auto BikeVertex1 = FastestPathVertex(EFastestPathLayer::Bike, Node1Vertex->second);
+                    auto BikeVertex2 = FastestPathVertex(EFastestPathLayer::Bike, Node2Vertex->second);
                     if (oneWay) {
-                        pathRouter->AddEdge(Node1Vertex->second, Node2Vertex->second, EdgeWeight, false);
+                        pathRouter->AddEdge(BikeVertex1, BikeVertex2, EdgeWeight, false);
                         continue;
                     } else {
-                        pathRouter->AddEdge(Node1Vertex->second, Node2Vertex->second, EdgeWeight, true);
+                        pathRouter->AddEdge(BikeVertex1, BikeVertex2, EdgeWeight, true);
                         continue;
                     }
                 }
@@ -228,40 +603,203 @@ struct CDijkstraTransportationPlanner::SImplementation {
         }
     }
 
+    // A trip starts from an origin vertex on foot or by bike and ends at a destination vertex either way
+    void CreateFastestPathEndpointEdges(std::shared_ptr<CPathRouter> pathRouter){
+        for (CPathRouter::TVertexID Vertex = 0; Vertex < SortedNodeIDs.size(); Vertex++) {
+            for (auto Layer : {EFastestPathLayer::Walk, EFastestPathLayer::Bike}) {
+                pathRouter->AddEdge(FastestPathVertex(EFastestPathLayer::Origin, Vertex), FastestPathVertex(Layer, Vertex), 0.0, false);
+                pathRouter->AddEdge(FastestPathVertex(Layer, Vertex), FastestPathVertex(EFastestPathLayer::Destination, Vertex), 0.0, false);
+            }
+        }
+    }
+
     double FindFastestPath(CStreetMap::TNodeID src, CStreetMap::TNodeID dest, std::vector<TTripStep>& path) {
-        std::vector <CPathRouter::TVertexID> BusWalkPath;
-        std::vector <CPathRouter::TVertexID> BikePath;
+        std::vector <CPathRouter::TVertexID> LayeredPath;
 
-        auto WalkBusRouter = std::make_shared<CDijkstraPathRouter>();
-        CreateStreetNodes(WalkBusRouter);
-        CreateFastestPathEdgesBusWalk(WalkBusRouter);
-        auto fastestWalkBusPath = WalkBusRouter->FindShortestPath(NodeToVertex[src], NodeToVertex[dest], BusWalkPath);
+        path.clear();
+        auto SrcVertex = NodeToVertex.find(src);
+        auto DestVertex = NodeToVertex.find(dest);
+        if (SrcVertex == NodeToVertex.end() || DestVertex == NodeToVertex.end()) {
+            return CPathRouter::NoPathExists;
+        }
 
-        auto BikeRouter = std::make_shared<CDijkstraPathRouter>();
-        CreateStreetNodes(BikeRouter);
-        CreateFastestPathBikingEdges(BikeRouter);
-        auto fastestBikePath = BikeRouter->FindShortestPath(NodeToVertex[src], NodeToVertex[dest], BikePath);
+        auto FastestTime = DFastestPathRouter->FindShortestPath(FastestPathVertex(EFastestPathLayer::Origin, SrcVertex->second), FastestPathVertex(EFastestPathLayer::Destination, DestVertex->second), LayeredPath);
+        if (FastestTime == CPathRouter::NoPathExists) {
+            return CPathRouter::NoPathExists;
+        }
 
-        path.clear();
-        if (fastestWalkBusPath < fastestBikePath) {
-            auto PathLength = BusWalkPath.size();
-            path.push_back({CTransportationPlanner::ETransportationMode::Walk, VertexToNode[BusWalkPath[0]]});
-            for (std::size_t Index = 1; Index < PathLength; Index++) {
-                auto Node = VertexToNode[BusWalkPath[Index]];
-                auto PrevNode = VertexToNode[BusWalkPath[Index - 1]];
-                if (DBusSystemIndexer->RouteBetweenNodeIDs(PrevNode, Node)) {
-                    path.push_back({CTransportationPlanner::ETransportationMode::Bus, Node});
+        // Each node is reported once with the mode used to reach it, the first with the mode the trip starts in.
+        // Origin and destination vertices and the transfers between layers at a node add no steps.
+        for (auto Vertex : LayeredPath) {
+            auto Layer = FastestPathLayer(Vertex);
+            if (Layer == EFastestPathLayer::Origin || Layer == EFastestPathLayer::Destination) {
+                continue;
+            }
+            auto Node = VertexToNode[FastestPathStreetVertex(Vertex)];
+            if (!path.empty() && path.back().second == Node) {
+                continue;
+            }
+            auto Mode = CTransportationPlanner::ETransportationMode::Walk;
+            if (Layer == EFastestPathLayer::Bike) {
+                Mode = CTransportationPlanner::ETransportationMode::Bike;
+            } else if (Layer == EFastestPathLayer::Bus && !path.empty()) {
+                Mode = CTransportationPlanner::ETransportationMode::Bus;
+            }
+            path.push_back({Mode, Node});
+        }
+        return FastestTime;
+    }
+
+    std::vector<std::vector<double>> FindDistanceMatrix(const std::vector<CStreetMap::TNodeID>& sources, const std::vector<CStreetMap::TNodeID>& targets, EDistanceMode mode) {
+        // Unknown nodes map to an invalid vertex, which the routers leave without a path
+        auto Vertices = [this, mode](const std::vector<CStreetMap::TNodeID>& nodes, EFastestPathLayer layer) {
+            std::vector<CPathRouter::TVertexID> Result;
+            for (auto NodeID : nodes) {
+                auto Vertex = NodeToVertex.find(NodeID);
+                if (Vertex == NodeToVertex.end()) {
+                    Result.push_back(CPathRouter::InvalidVertexID);
                 } else {
-                    path.push_back({CTransportationPlanner::ETransportationMode::Walk, Node});
+                    Result.push_back(mode == EDistanceMode::Fastest ? FastestPathVertex(layer, Vertex->second) : Vertex->second);
                 }
             }
-            return fastestWalkBusPath;                
-        } else {
-            for (auto Vertex : BikePath) {
-                path.push_back({CTransportationPlanner::ETransportationMode::Bike, VertexToNode[Vertex]});
+            return Result;
+        };
+        std::vector<std::vector<double>> Matrix;
+        auto &Router = mode == EDistanceMode::Fastest ? DFastestPathRouter : DShortestPathRouter;
+        Router->FindDistances(Vertices(sources, EFastestPathLayer::Origin), Vertices(targets, EFastestPathLayer::Destination), Matrix);
+        return Matrix;
+    }
+
+    // Walking distance in miles, walkers may go either way on one way streets
+    double WalkDistance(CStreetMap::TNodeID src, CStreetMap::TNodeID dest, std::vector<CStreetMap::TNodeID>& path) {
+        path.clear();
+        auto SrcVertex = NodeToVertex.find(src);
+        auto DestVertex = NodeToVertex.find(dest);
+        if (SrcVertex == NodeToVertex.end() || DestVertex == NodeToVertex.end()) {
+            return CPathRouter::NoPathExists;
+        }
+        std::vector<CPathRouter::TVertexID> WalkPath;
+        auto Distance = DWalkPathRouter->FindShortestPath(SrcVertex->second, DestVertex->second, WalkPath);
+        for (auto Vertex : WalkPath) {
+            path.push_back(VertexToNode[Vertex]);
+        }
+        return Distance;
+    }
+
+    CRaptorTransitRouter::TTime WalkSeconds(double distance) const {
+        return CRaptorTransitRouter::TTime(std::ceil(distance / DWalkSpeed * 3600));
+    }
+
+    // A timetable ride can be described like a bus step of a fastest path when the bus system has
+    // the route stop there next
+    bool KnownBusHop(const std::string& route, CBusSystem::TStopID src, CBusSystem::TStopID dest) const {
+        auto SourceStop = DBusSystem->StopByID(src);
+        auto DestinationStop = DBusSystem->StopByID(dest);
+        std::unordered_set<std::shared_ptr<CBusSystem::SRoute>> Routes;
+        if (!SourceStop || !DestinationStop || !DBusSystemIndexer->RoutesByNodeIDs(SourceStop->NodeID(), DestinationStop->NodeID(), Routes)) {
+            return false;
+        }
+        return std::any_of(Routes.begin(), Routes.end(), [&route](const std::shared_ptr<CBusSystem::SRoute>& known) {
+            return known->Name() == route;
+        });
+    }
+
+    bool LoadSchedule(std::shared_ptr<CDSVReader> stoptimes) {
+        DSchedule = std::make_shared<CRaptorTransitRouter>(stoptimes, [this](const std::string& route, CBusSystem::TStopID src, CBusSystem::TStopID dest) {
+            return KnownBusHop(route, src, dest);
+        });
+        ScheduleStops.clear();
+        for (auto StopID : DSchedule->Stops()) {
+            auto Stop = DBusSystem->StopByID(StopID);
+            if (Stop && NodeToVertex.find(Stop->NodeID()) != NodeToVertex.end()) {
+                ScheduleStops.push_back(std::make_pair(StopID, Stop->NodeID()));
             }
-            return fastestBikePath;
         }
+        std::vector<CStreetMap::TNodeID> WalkPath;
+        for (auto &Source : ScheduleStops) {
+            auto SourceLocation = DStreetMap->NodeByID(Source.second)->Location();
+            for (auto &Destination : ScheduleStops) {
+                if (Source.first == Destination.first || SGeographicUtils::HaversineDistanceInMiles(SourceLocation, DStreetMap->NodeByID(Destination.second)->Location()) > MaxTransferDistance) {
+                    continue;
+                }
+                auto Distance = WalkDistance(Source.second, Destination.second, WalkPath);
+                if (Distance != CPathRouter::NoPathExists) {
+                    DSchedule->AddTransfer(Source.first, Destination.first, WalkSeconds(Distance));
+                }
+            }
+        }
+        return DSchedule->TripCount() > 0;
+    }
+
+    // Appends the walk between two nodes, the first node is already the last step of the path
+    void AppendWalk(CStreetMap::TNodeID src, CStreetMap::TNodeID dest, std::vector<TTripStep>& path) {
+        std::vector<CStreetMap::TNodeID> WalkPath;
+        WalkDistance(src, dest, WalkPath);
+        for (std::size_t Index = 1; Index < WalkPath.size(); Index++) {
+            path.push_back({CTransportationPlanner::ETransportationMode::Walk, WalkPath[Index]});
+        }
+    }
+
+    double FindScheduledPath(CStreetMap::TNodeID src, CStreetMap::TNodeID dest, double departure, std::vector<TTripStep>& path) {
+        path.clear();
+        if (NodeToVertex.find(src) == NodeToVertex.end() || NodeToVertex.find(dest) == NodeToVertex.end()) {
+            return CPathRouter::NoPathExists;
+        }
+        std::vector<CStreetMap::TNodeID> WalkPath;
+        auto WalkTime = WalkDistance(src, dest, WalkPath);
+        if (WalkTime != CPathRouter::NoPathExists) {
+            WalkTime /= DWalkSpeed;
+        }
+
+        std::vector<CRaptorTransitRouter::SLeg> Journey;
+        auto TransitTime = CPathRouter::NoPathExists;
+        if (DSchedule) {
+            std::vector<std::pair<CRaptorTransitRouter::TStopID, CRaptorTransitRouter::TTime>> Access, Egress;
+            auto SourceLocation = DStreetMap->NodeByID(src)->Location();
+            auto DestinationLocation = DStreetMap->NodeByID(dest)->Location();
+            std::vector<CStreetMap::TNodeID> StopPath;
+            for (auto &Stop : ScheduleStops) {
+                auto StopLocation = DStreetMap->NodeByID(Stop.second)->Location();
+                if (SGeographicUtils::HaversineDistanceInMiles(SourceLocation, StopLocation) <= MaxAccessDistance) {
+                    auto Distance = WalkDistance(src, Stop.second, StopPath);
+                    if (Distance != CPathRouter::NoPathExists) {
+                        Access.push_back(std::make_pair(Stop.first, WalkSeconds(Distance)));
+                    }
+                }
+                if (SGeographicUtils::HaversineDistanceInMiles(StopLocation, DestinationLocation) <= MaxAccessDistance) {
+                    auto Distance = WalkDistance(Stop.second, dest, StopPath);
+                    if (Distance != CPathRouter::NoPathExists) {
+                        Egress.push_back(std::make_pair(Stop.first, WalkSeconds(Distance)));
+                    }
+                }
+            }
+            auto DepartureTime = CRaptorTransitRouter::TTime(std::llround(departure * 3600));
+            auto Arrival = DSchedule->FindEarliestArrival(Access, Egress, DepartureTime, Journey);
+            if (Arrival != CRaptorTransitRouter::NoArrival && !Journey.empty()) {
+                TransitTime = double(Arrival - DepartureTime) / 3600;
+            }
+        }
+
+        if (TransitTime == CPathRouter::NoPathExists || (WalkTime != CPathRouter::NoPathExists && WalkTime <= TransitTime)) {
+            for (auto Node : WalkPath) {
+                path.push_back({CTransportationPlanner::ETransportationMode::Walk, Node});
+            }
+            return WalkTime;
+        }
+        std::unordered_map<CBusSystem::TStopID, CStreetMap::TNodeID> StopNodes(ScheduleStops.begin(), ScheduleStops.end());
+        path.push_back({CTransportationPlanner::ETransportationMode::Walk, src});
+        AppendWalk(src, StopNodes[Journey.front().DStops.front()], path);
+        for (auto &Leg : Journey) {
+            if (Leg.DWalk) {
+                AppendWalk(StopNodes[Leg.DStops.front()], StopNodes[Leg.DStops.back()], path);
+                continue;
+            }
+            for (std::size_t Index = 1; Index < Leg.DStops.size(); Index++) {
+                path.push_back({CTransportationPlanner::ETransportationMode::Bus, StopNodes[Leg.DStops[Index]]});
+            }
+        }
+        AppendWalk(StopNodes[Journey.back().DStops.back()], dest, path);
+        return TransitTime;
     }
 
     bool GetPathWays(const std::vector<TTripStep>& path, std::vector<CStreetMap::TWayID>& Ways) const{
@@ -270,12 +808,13 @@ struct CDijkstraTransportationPlanner::SImplementation {
         for (std::size_t CurrentIndex = 1; CurrentIndex < PathLength; CurrentIndex++){
             auto CurrentNodeID = path[CurrentIndex].second;
             auto PrevNodeID = path[CurrentIndex - 1].second;
-            auto PairWayID = NodePairToWay.find(std::make_pair(PrevNodeID, CurrentNodeID));
-            if (PairWayID == NodePairToWay.end()) {
+            auto WayID = FindWay(PrevNodeID, CurrentNodeID);
+            // A scheduled bus may ride between stops that no way joins, bus steps are described by route
+            if (WayID == CStreetMap::InvalidWayID && path[CurrentIndex].first != CTransportationPlanner::ETransportationMode::Bus) {
                 std::cout << "No way found between nodes " << PrevNodeID << " and " << CurrentNodeID << std::endl;
                 return false;
             }
-            Ways.push_back(PairWayID->second);
+            Ways.push_back(WayID);
         }
         // for (const auto& WayID : Ways) {
         //     std::cout << "Way ID: " << WayID << std::endl;
@@ -287,8 +826,7 @@ struct CDijkstraTransportationPlanner::SImplementation {
         std::vector<std::string> StreetNames;
         for (auto WayID : Ways) {
             auto Way = DStreetMap->WayByID(WayID);
-            auto StreetName = Way->GetAttribute("name");
-            StreetNames.push_back(StreetName);
+            StreetNames.push_back(Way ? Way->GetAttribute("name") : "");
         }
         // for (const auto& name : StreetNames) {
         //     std::cout << name << std::endl;
@@ -439,6 +977,15 @@ struct CDijkstraTransportationPlanner::SImplementation {
                         UniqueNodes.push_back(path[Index].second);
                     } else {
                         CurrCommonRoutes = Intersection(PrevCommonRoutes, CurrRouteSet);
+                        // No route serves the whole ride so far, the bus was changed at the previous stop
+                        if (CurrCommonRoutes.empty()){
+                            UniqueWays.push_back(PlaceholderValue);
+                            UniqueStreetNames.push_back("Bus");
+                            UniqueRoutes.push_back(*PrevCommonRoutes.begin());
+                            UniqueModes.push_back(CTransportationPlanner::ETransportationMode::Bus);
+                            CurrCommonRoutes = CurrRouteSet;
+                            UniqueNodes.push_back(path[Index].second);
+                        }
                     }
                     if (Index == (NumWays - 1)){
                         // UniqueWays.push_back(CStreetMap::InvalidWayID);
@@ -549,7 +1096,39 @@ struct CDijkstraTransportationPlanner::SImplementation {
 };
 
 CDijkstraTransportationPlanner::CDijkstraTransportationPlanner(std::shared_ptr<SConfiguration> config) {
-    DImplementation = std::make_unique<SImplementation>(config);
+    DImplementation = std::make_unique<SImplementation>(config, nullptr, nullptr);
+}
+
+CDijkstraTransportationPlanner::CDijkstraTransportationPlanner(std::shared_ptr<SConfiguration> config, std::shared_ptr<CDataSource> artifacts, std::shared_ptr<CDSVReader> buspaths) {
+    DImplementation = std::make_unique<SImplementation>(config, artifacts, buspaths);
+}
+
+bool CDijkstraTransportationPlanner::SaveArtifacts(std::shared_ptr<CDataSink> sink) const {
+    return DImplementation->SaveArtifacts(sink);
+}
+
+bool CDijkstraTransportationPlanner::ArtifactsLoaded() const noexcept {
+    return DImplementation->DArtifactsLoaded;
+}
+
+std::vector<std::vector<double>> CDijkstraTransportationPlanner::FindDistanceMatrix(const std::vector<TNodeID> &sources, const std::vector<TNodeID> &targets, EDistanceMode mode) {
+    return DImplementation->FindDistanceMatrix(sources, targets, mode);
+}
+
+CDijkstraTransportationPlanner::TNodeID CDijkstraTransportationPlanner::FindNearestNode(CStreetMap::TLocation location) const noexcept {
+    return DImplementation->DNodeIndex->NearestNode(location);
+}
+
+std::vector<CDijkstraTransportationPlanner::TNodeID> CDijkstraTransportationPlanner::FindNearestNodes(CStreetMap::TLocation location, std::size_t count) const {
+    return DImplementation->DNodeIndex->NearestNodes(location, count);
+}
+
+bool CDijkstraTransportationPlanner::LoadSchedule(std::shared_ptr<CDSVReader> stoptimes) {
+    return DImplementation->LoadSchedule(stoptimes);
+}
+
+double CDijkstraTransportationPlanner::FindScheduledPath(TNodeID src, TNodeID dest, double departure, std::vector<TTripStep> &path) {
+    return DImplementation->FindScheduledPath(src, dest, departure, path);
 }
 
 CDijkstraTransportationPlanner::~CDijkstraTransportationPlanner() = default;
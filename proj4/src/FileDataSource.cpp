@@ -8,7 +8,8 @@ CFileDataSource::CFileDataSource(const std::string &filename){
 }
 
 bool CFileDataSource::End() const noexcept{
-    return DFile.eof();
+    // A file that failed to open has nothing to read either
+    return !DFile.good();
 }
 
 bool CFileDataSource::Get(char &ch) noexcept{
@@ -34,11 +35,12 @@ bool CFileDataSource::Read(std::vector<char> &buf, std::size_t count) noexcept{
     if(!DFile.good()){
         return false;
     }
-    char TempCh;
-    buf.clear();
-    buf.reserve(count);
-    while(buf.size() < count && Get(TempCh)){
-        buf.push_back(TempCh);
+    // One bulk read instead of a Get per character, the peek keeps End() accurate
+    buf.resize(count);
+    DFile.read(buf.data(), count);
+    buf.resize(DFile.gcount());
+    if(DFile.good()){
+        DFile.peek();
     }
     return !buf.empty();
 }
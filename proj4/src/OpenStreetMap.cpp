@@ -3,50 +3,89 @@
 #include <vector> // Add this include for std::vector
 #include <string> // Add this include for std::string
 #include <memory> // Add this include for std::make_shared
+#include <unordered_map>
+#include <algorithm>
+#include <deque>
+#include <string_view>
+#include <limits>
+#include <cstdint>
+#include <cstring>
+#include <charconv>
+#include <stdexcept>
+#include <expat.h>
 
 // Internal implementation struct
 struct COpenStreetMap::SImplementation {
-    struct SNodeImpl : public CStreetMap::SNode {
-        TNodeID OSM_NodeID;
-        TLocation OSM_Node_Location;
-        std::vector<std::pair<std::string, std::string>> OSM_Node_Attributes; // Define Attributes type
-        
-        TNodeID ID() const noexcept override {
-            return OSM_NodeID;
+    // Tag keys and values repeat across thousands of nodes and ways, so each distinct string is
+    // stored once and attributes hold its atom. Comparing keys is then an integer compare.
+    struct SStringPool {
+        using TAtom = uint32_t;
+        static constexpr TAtom NoAtom = std::numeric_limits<TAtom>::max();
+
+        // A deque never moves its strings, so the views in Atoms stay valid
+        std::deque<std::string> Strings;
+        std::unordered_map<std::string_view, TAtom> Atoms;
+
+        TAtom Intern(std::string_view str) {
+            auto Search = Atoms.find(str);
+            if (Search != Atoms.end()) {
+                return Search->second;
+            }
+            Strings.emplace_back(str);
+            TAtom Atom = Strings.size() - 1;
+            Atoms.emplace(Strings.back(), Atom);
+            return Atom;
         }
 
-        TLocation Location() const noexcept override {
-            return OSM_Node_Location;
+        // Atom of a string that was interned, NoAtom if it never was
+        TAtom Find(std::string_view str) const {
+            auto Search = Atoms.find(str);
+            return Search == Atoms.end() ? NoAtom : Search->second;
         }
 
-        std::size_t AttributeCount() const noexcept override {
-            return OSM_Node_Attributes.size();
+        const std::string &String(TAtom atom) const {
+            return Strings[atom];
         }
+    };
 
-        std::string GetAttributeKey(std::size_t index) const noexcept override {
+    // Key/value atoms of a node's or way's attributes in document order
+    struct SAttributes {
+        std::vector<std::pair<SStringPool::TAtom, SStringPool::TAtom>> Atoms;
+
+        std::size_t Count() const {
+            return Atoms.size();
+        }
+
+        std::string Key(const SStringPool &pool, std::size_t index) const {
             // If index is valid, return the key
-            if (index < AttributeCount()) {
-                return OSM_Node_Attributes[index].first;
+            if (index < Atoms.size()) {
+                return pool.String(Atoms[index].first);
             }
             // Otherwise, return an empty string
             return "";
         }
 
-        bool HasAttribute(const std::string &key) const noexcept override {
-            // Check if the key exists by iterating through the attributes
-            for (const auto &Attribute : OSM_Node_Attributes) {
-                if (Attribute.first == key) {
+        bool Has(const SStringPool &pool, const std::string &key) const {
+            // A key that was never interned is on no node or way
+            auto KeyAtom = pool.Find(key);
+            if (KeyAtom == SStringPool::NoAtom) {
+                return false;
+            }
+            for (const auto &Attribute : Atoms) {
+                if (Attribute.first == KeyAtom) {
                     return true;
                 }
             }
             return false;
         }
 
-        std::string GetAttribute(const std::string &key) const noexcept override {
-            // Iterate over the attributes to find the key
-            for (const auto &Attribute : OSM_Node_Attributes) {
-                if (Attribute.first == key) {
-                    return Attribute.second;
+        std::string Get(const SStringPool &pool, const std::string &key) const {
+            auto KeyAtom = pool.Find(key);
+            if (KeyAtom != SStringPool::NoAtom) {
+                for (const auto &Attribute : Atoms) {
+                    if (Attribute.first == KeyAtom) {
+                        return pool.String(Attribute.second);
+                    }
                 }
             }
             // Return an empty string if the key is not found
@@ -54,10 +93,63 @@ struct COpenStreetMap::SImplementation {
         }
     };
 
+    // Nodes are stored by column, a node is just its position in these arrays
+    struct SNodeStore {
+        std::vector<TNodeID> IDs;
+        std::vector<double> Latitudes;
+        std::vector<double> Longitudes;
+        // Attributes of the few nodes that have any, keyed by node index
+        std::unordered_map<std::size_t, SAttributes> Attributes;
+        std::shared_ptr<const SStringPool> Strings;
+
+        const SAttributes *NodeAttributes(std::size_t index) const {
+            auto Search = Attributes.find(index);
+            return Search == Attributes.end() ? nullptr : &Search->second;
+        }
+    };
+
+    // Lightweight view of one stored node, created on demand. It shares ownership of the
+    // store so it stays valid after the map is gone, like the nodes it replaces.
+    struct SNodeView : public CStreetMap::SNode {
+        std::shared_ptr<const SNodeStore> Store;
+        std::size_t Index;
+
+        SNodeView(std::shared_ptr<const SNodeStore> store, std::size_t index) : Store(std::move(store)), Index(index) {}
+
+        TNodeID ID() const noexcept override {
+            return Store->IDs[Index];
+        }
+
+        TLocation Location() const noexcept override {
+            return std::make_pair(Store->Latitudes[Index], Store->Longitudes[Index]);
+        }
+
+        std::size_t AttributeCount() const noexcept override {
+            auto Attributes = Store->NodeAttributes(Index);
+            return Attributes ? Attributes->Count() : 0;
+        }
+
+        std::string GetAttributeKey(std::size_t index) const noexcept override {
+            auto Attributes = Store->NodeAttributes(Index);
+            return Attributes ? Attributes->Key(*Store->Strings, index) : "";
+        }
+
+        bool HasAttribute(const std::string &key) const noexcept override {
+            auto Attributes = Store->NodeAttributes(Index);
+            return Attributes && Attributes->Has(*Store->Strings, key);
+        }
+
+        std::string GetAttribute(const std::string &key) const noexcept override {
+            auto Attributes = Store->NodeAttributes(Index);
+            return Attributes ? Attributes->Get(*Store->Strings, key) : "";
+        }
+    };
+
     struct SWayImpl : public CStreetMap::SWay {
         TWayID OSM_WayID;
         std::vector<TNodeID> OSM_NodeIDs;
-        std::vector<std::pair<std::string, std::string>> OSM_Way_Attributes; // Define Attributes type
+        SAttributes OSM_Way_Attributes;
+        std::shared_ptr<const SStringPool> OSM_Strings;
 
         TWayID ID() const noexcept override {
             return OSM_WayID;
@@ -75,97 +167,240 @@ struct COpenStreetMap::SImplementation {
         }
 
         std::size_t AttributeCount() const noexcept override {
-            return OSM_Way_Attributes.size();
+            return OSM_Way_Attributes.Count();
         }
 
         std::string GetAttributeKey(std::size_t index) const noexcept override {
-            // If index is valid, return the key
-            if (index < AttributeCount()) {
-                return OSM_Way_Attributes[index].first;
-            }
-            // Otherwise, return an empty string
-            return "";
+            return OSM_Way_Attributes.Key(*OSM_Strings, index);
         }
 
         bool HasAttribute(const std::string &key) const noexcept override {
-            // Check if the key exists by iterating through the attributes
-            for (const auto &Attribute : OSM_Way_Attributes) {
-                if (Attribute.first == key) {
-                    return true;
-                }
-            }
-            return false;
+            return OSM_Way_Attributes.Has(*OSM_Strings, key);
         }
 
         std::string GetAttribute(const std::string &key) const noexcept override {
-            // Iterate over the attributes to find the key
-            for (const auto &Attribute : OSM_Way_Attributes) {
-                if (Attribute.first == key) {
-                    return Attribute.second;
-                }
-            }
-            // Return an empty string if the key is not found
-            return "";
+            return OSM_Way_Attributes.Get(*OSM_Strings, key);
         }
     };
 
     std::shared_ptr<CXMLReader> OSM_XMLReader;
-    std::vector<std::shared_ptr<SNodeImpl>> OSM_Nodes;
+    std::shared_ptr<SStringPool> OSM_Strings = std::make_shared<SStringPool>();
+    std::shared_ptr<SNodeStore> OSM_Nodes = std::make_shared<SNodeStore>();
     std::vector<std::shared_ptr<SWayImpl>> OSM_Ways;
+    // OSM extracts list nodes in increasing ID order, so NodeByID binary searches the ID column.
+    // Only if they are out of order is this index built, the first node wins if an ID repeats.
+    bool OSM_NodeIDsSorted = true;
+    std::unordered_map<TNodeID, std::size_t> OSM_NodeIndexByID;
+    // Position of each ID in OSM_Ways, the first one wins if an ID repeats
+    std::unordered_map<TWayID, std::size_t> OSM_WayIndexByID;
+
+    // Element whose tags are being read, tags outside a node or way are ignored
+    enum class EOpenElement {None, Node, Way};
+    EOpenElement OSM_OpenElement = EOpenElement::None;
+    SAttributes OSM_OpenAttributes;
+    std::shared_ptr<SWayImpl> OSM_OpenWay;
+    // Only set while the expat loader runs, so a handler can abort the parse
+    XML_Parser OSM_Parser = nullptr;
+    std::string OSM_LoadError;
+
+    // Both loaders feed the map through these, one element at a time
+    void BeginNode(TNodeID id, double lat, double lon) {
+        auto &Nodes = *OSM_Nodes;
+        if (!Nodes.IDs.empty() && Nodes.IDs.back() >= id) {
+            OSM_NodeIDsSorted = false;
+        }
+        Nodes.IDs.push_back(id);
+        Nodes.Latitudes.push_back(lat);
+        Nodes.Longitudes.push_back(lon);
+        OSM_OpenElement = EOpenElement::Node;
+        OSM_OpenAttributes.Atoms.clear();
+    }
+
+    void BeginWay(TWayID id) {
+        OSM_OpenWay = std::make_shared<SWayImpl>();
+        OSM_OpenWay->OSM_WayID = id;
+        OSM_OpenWay->OSM_Strings = OSM_Strings;
+        OSM_OpenElement = EOpenElement::Way;
+    }
+
+    void AddWayNode(TNodeID id) {
+        if (OSM_OpenElement == EOpenElement::Way) {
+            OSM_OpenWay->OSM_NodeIDs.push_back(id);
+        }
+    }
+
+    void AddAttribute(std::string_view key, std::string_view value) {
+        auto Attribute = std::make_pair(OSM_Strings->Intern(key), OSM_Strings->Intern(value));
+        if (OSM_OpenElement == EOpenElement::Node) {
+            OSM_OpenAttributes.Atoms.push_back(Attribute);
+        } else if (OSM_OpenElement == EOpenElement::Way) {
+            OSM_OpenWay->OSM_Way_Attributes.Atoms.push_back(Attribute);
+        }
+    }
+
+    void EndElement() {
+        if (OSM_OpenElement == EOpenElement::Node) {
+            if (OSM_OpenAttributes.Count()) {
+                OSM_Nodes->Attributes[OSM_Nodes->IDs.size() - 1] = std::move(OSM_OpenAttributes);
+                OSM_OpenAttributes = SAttributes();
+            }
+        } else if (OSM_OpenElement == EOpenElement::Way) {
+            OSM_WayIndexByID.emplace(OSM_OpenWay->OSM_WayID, OSM_Ways.size());
+            OSM_Ways.push_back(std::move(OSM_OpenWay));
+        }
+        OSM_OpenElement = EOpenElement::None;
+    }
+
+    void FinishLoading() {
+        if (!OSM_NodeIDsSorted) {
+            for (std::size_t Index = 0; Index < OSM_Nodes->IDs.size(); Index++) {
+                OSM_NodeIndexByID.emplace(OSM_Nodes->IDs[Index], Index);
+            }
+        }
+    }
+
+    // Attributes of a node other than its ID and location are kept with its tags
+    static bool IsNodeLocationAttribute(std::string_view name) {
+        return name == "id" || name == "lat" || name == "lon";
+    }
 
     SImplementation(std::shared_ptr<CXMLReader> src) {
-        OSM_XMLReader = src;
+        OSM_Nodes->Strings = OSM_Strings;
         SXMLEntity Entity;
-        while (OSM_XMLReader->ReadEntity(Entity, true)) {
+        while (src->ReadEntity(Entity, true)) {
             if (Entity.DType == SXMLEntity::EType::StartElement) {
-                if (Entity.DNameData == "node"){
-                    auto Node = std::make_shared<SNodeImpl>();
-
-                    // First extract the ID and location of the node
-                    // std::stoull converts a string to an unsigned long long
-                    Node->OSM_NodeID = std::stoull(Entity.AttributeValue("id"));
-                    // std::stod converts a string to a double
-                    Node->OSM_Node_Location.first = std::stod(Entity.AttributeValue("lat"));
-                    Node->OSM_Node_Location.second = std::stod(Entity.AttributeValue("lon"));
-                    
-                    if (Entity.DAttributes.size() > 3){
-                        // Add all the attributes of the node
-                        for (size_t Index = 3; Index < Entity.DAttributes.size(); Index++) {
-                            Node->OSM_Node_Attributes.push_back(std::make_pair(Entity.DAttributes[Index].first, Entity.DAttributes[Index].second));
-                        }
-                    }
-                    // Keep reading till you hit the node end tag 
-                    while (OSM_XMLReader->ReadEntity(Entity, true)) {
-                        // If the entity is an end element and the name is "node", break
-                        if (Entity.DType == SXMLEntity::EType::EndElement && Entity.DNameData == "node") {
-                            OSM_Nodes.push_back(Node);  // Add the node to the list of nodes
-                            break;
-                        }
-                        // If the entity is a start element and the name is "tag", add the attributes
-                        if (Entity.DType == SXMLEntity::EType::StartElement && Entity.DNameData == "tag") {
-                            // Add the tag attributes to the node
-                            Node->OSM_Node_Attributes.push_back(std::make_pair(Entity.DAttributes[0].second, Entity.DAttributes[1].second));                                
+                if (Entity.DNameData == "node") {
+                    // std::stoull converts a string to an unsigned long long, std::stod to a double
+                    BeginNode(std::stoull(Entity.AttributeValue("id")), std::stod(Entity.AttributeValue("lat")), std::stod(Entity.AttributeValue("lon")));
+                    for (const auto &Attribute : Entity.DAttributes) {
+                        if (!IsNodeLocationAttribute(Attribute.first)) {
+                            AddAttribute(Attribute.first, Attribute.second);
                         }
                     }
                 } else if (Entity.DNameData == "way") {
-                    auto Way = std::make_shared<SWayImpl>();
-                    Way->OSM_WayID = std::stoull(Entity.AttributeValue("id"));
-                    while (OSM_XMLReader->ReadEntity(Entity, true)) {
-                        if (Entity.DType == SXMLEntity::EType::EndElement && Entity.DNameData == "way") {
-                            OSM_Ways.push_back(Way);
-                            break;
-                        }
-                        if (Entity.DType == SXMLEntity::EType::StartElement && Entity.DNameData == "nd") {
-                            // Add the node ID to the way
-                            Way->OSM_NodeIDs.push_back(std::stoull(Entity.AttributeValue("ref")));
-                        } else if (Entity.DType == SXMLEntity::EType::StartElement && Entity.DNameData == "tag") {
-                            // Add the tag attributes to the way
-                            Way->OSM_Way_Attributes.push_back(std::make_pair(Entity.DAttributes[0].second, Entity.DAttributes[1].second));
-                        }
-                    }
+                    BeginWay(std::stoull(Entity.AttributeValue("id")));
+                } else if (Entity.DNameData == "nd") {
+                    AddWayNode(std::stoull(Entity.AttributeValue("ref")));
+                } else if (Entity.DNameData == "tag") {
+                    AddAttribute(Entity.DAttributes[0].second, Entity.DAttributes[1].second);
+                }
+            } else if (Entity.DType == SXMLEntity::EType::EndElement && (Entity.DNameData == "node" || Entity.DNameData == "way")) {
+                EndElement();
+            }
+        }
+        FinishLoading();
+    }
+
+    // Loads straight from the raw document with expat callbacks. Numbers are parsed in place
+    // and only tag strings that have not been seen before are copied into the string pool.
+    // A malformed document or a bad number fails the whole load with std::runtime_error.
+    SImplementation(std::shared_ptr<CDataSource> src) {
+        OSM_Nodes->Strings = OSM_Strings;
+        OSM_Parser = XML_ParserCreate(nullptr);
+        XML_SetUserData(OSM_Parser, this);
+        XML_SetElementHandler(OSM_Parser, StartElementHandler, EndElementHandler);
+        std::vector<char> Buffer;
+        bool Parsed = true;
+        while (Parsed && src->Read(Buffer, 65536)) {
+            Parsed = XML_Parse(OSM_Parser, Buffer.data(), Buffer.size(), XML_FALSE) != XML_STATUS_ERROR;
+        }
+        if (Parsed) {
+            Parsed = XML_Parse(OSM_Parser, nullptr, 0, XML_TRUE) != XML_STATUS_ERROR;
+        }
+        if (!Parsed && OSM_LoadError.empty()) {
+            OSM_LoadError = std::string(XML_ErrorString(XML_GetErrorCode(OSM_Parser))) + " at line " + std::to_string(XML_GetCurrentLineNumber(OSM_Parser));
+        }
+        XML_ParserFree(OSM_Parser);
+        OSM_Parser = nullptr;
+        if (!OSM_LoadError.empty()) {
+            throw std::runtime_error("Invalid OSM document: " + OSM_LoadError);
+        }
+        FinishLoading();
+    }
+
+    // Stops the parse at the current element, the first error is the one reported
+    void AbortLoad(const std::string &error) {
+        if (OSM_LoadError.empty()) {
+            OSM_LoadError = error + " at line " + std::to_string(XML_GetCurrentLineNumber(OSM_Parser));
+        }
+        XML_StopParser(OSM_Parser, XML_FALSE);
+    }
+
+    // False unless all of str is a number, like the std::stoull and std::stod of the XMLReader path
+    template <typename TNumber>
+    static bool ParseNumber(const XML_Char *str, TNumber &value) {
+        auto End = str + std::strlen(str);
+        auto Result = std::from_chars(str, End, value);
+        return Result.ec == std::errc() && Result.ptr == End && End != str;
+    }
+
+    static const XML_Char *FindAttribute(const XML_Char **atts, const char *name) {
+        for (int Index = 0; atts[Index]; Index += 2) {
+            if (std::strcmp(atts[Index], name) == 0) {
+                return atts[Index + 1];
+            }
+        }
+        return "";
+    }
+
+    static void StartElementHandler(void *userData, const XML_Char *name, const XML_Char **atts) {
+        auto Impl = static_cast<SImplementation*>(userData);
+        if (std::strcmp(name, "node") == 0) {
+            TNodeID ID;
+            double Latitude, Longitude;
+            if (!ParseNumber(FindAttribute(atts, "id"), ID) || !ParseNumber(FindAttribute(atts, "lat"), Latitude) || !ParseNumber(FindAttribute(atts, "lon"), Longitude)) {
+                Impl->AbortLoad("bad node id or location");
+                return;
+            }
+            Impl->BeginNode(ID, Latitude, Longitude);
+            for (int Index = 0; atts[Index]; Index += 2) {
+                if (!IsNodeLocationAttribute(atts[Index])) {
+                    Impl->AddAttribute(atts[Index], atts[Index + 1]);
                 }
             }
+        } else if (std::strcmp(name, "way") == 0) {
+            TWayID ID;
+            if (!ParseNumber(FindAttribute(atts, "id"), ID)) {
+                Impl->AbortLoad("bad way id");
+                return;
+            }
+            Impl->BeginWay(ID);
+        } else if (std::strcmp(name, "nd") == 0) {
+            TNodeID Ref;
+            if (!ParseNumber(FindAttribute(atts, "ref"), Ref)) {
+                Impl->AbortLoad("bad way node ref");
+                return;
+            }
+            Impl->AddWayNode(Ref);
+        } else if (std::strcmp(name, "tag") == 0) {
+            Impl->AddAttribute(FindAttribute(atts, "k"), FindAttribute(atts, "v"));
+        }
+    }
+
+    static void EndElementHandler(void *userData, const XML_Char *name) {
+        if (std::strcmp(name, "node") == 0 || std::strcmp(name, "way") == 0) {
+            static_cast<SImplementation*>(userData)->EndElement();
+        }
+    }
+
+    std::shared_ptr<CStreetMap::SNode> NodeAt(std::size_t index) const {
+        return std::make_shared<SNodeView>(OSM_Nodes, index);
+    }
+
+    std::shared_ptr<CStreetMap::SNode> NodeByID(TNodeID id) const {
+        if (OSM_NodeIDsSorted) {
+            const auto &IDs = OSM_Nodes->IDs;
+            auto Search = std::lower_bound(IDs.begin(), IDs.end(), id);
+            if (Search != IDs.end() && *Search == id) {
+                return NodeAt(Search - IDs.begin());
+            }
+            return nullptr;
+        }
+        auto Search = OSM_NodeIndexByID.find(id);
+        if (Search != OSM_NodeIndexByID.end()) {
+            return NodeAt(Search->second);
         }
+        return nullptr;
     }
 };
 
@@ -173,10 +408,14 @@ COpenStreetMap::COpenStreetMap(std::shared_ptr<CXMLReader> src){
     DImplementation = std::make_unique<SImplementation>(src);
 } 
 
+COpenStreetMap::COpenStreetMap(std::shared_ptr<CDataSource> src){
+    DImplementation = std::make_unique<SImplementation>(src);
+}
+
 COpenStreetMap::~COpenStreetMap() = default;
 
 std::size_t COpenStreetMap::NodeCount() const noexcept {
-    return DImplementation->OSM_Nodes.size();
+    return DImplementation->OSM_Nodes->IDs.size();
 }
 
 std::size_t COpenStreetMap::WayCount() const noexcept {
@@ -185,18 +424,13 @@ std::size_t COpenStreetMap::WayCount() const noexcept {
 
 std::shared_ptr<CStreetMap::SNode> COpenStreetMap::NodeByIndex(std::size_t index) const noexcept {
     if (index < NodeCount()) {
-        return DImplementation->OSM_Nodes[index];
+        return DImplementation->NodeAt(index);
     }
     return nullptr;
 }
 
 std::shared_ptr<CStreetMap::SNode> COpenStreetMap::NodeByID(TNodeID id) const noexcept {
-    for (const auto &Node : DImplementation->OSM_Nodes) {
-        if (Node->ID() == id) {
-            return Node;
-        }
-    }
-    return nullptr;
+    return DImplementation->NodeByID(id);
 }
 
 std::shared_ptr<CStreetMap::SWay> COpenStreetMap::WayByIndex(std::size_t index) const noexcept {
@@ -207,10 +441,9 @@ std::shared_ptr<CStreetMap::SWay> COpenStreetMap::WayByIndex(std::size_t index)
 }
 
 std::shared_ptr<CStreetMap::SWay> COpenStreetMap::WayByID(TWayID id) const noexcept {
-    for (const auto &Way : DImplementation->OSM_Ways) {
-        if (Way->ID() == id) {
-            return Way;
-        }
+    auto Search = DImplementation->OSM_WayIndexByID.find(id);
+    if (Search != DImplementation->OSM_WayIndexByID.end()) {
+        return DImplementation->OSM_Ways[Search->second];
     }
     return nullptr;
 }
\ No newline at end of file
@@ -0,0 +1,378 @@
+#include "RaptorTransitRouter.h"
+#include "StringUtils.h"
+#include <unordered_map>
+#include <map>
+#include <algorithm>
+#include <charconv>
+
+struct CRaptorTransitRouter::SImplementation{
+    // Trips that visit the same stops, sorted so no trip arrives anywhere before the one ahead
+    // of it. Times are stored trip by trip, a single time is both arrival and departure.
+    struct SPattern{
+        std::string DRoute;
+        std::vector<uint32_t> DStops;
+        std::vector<std::string> DTrips;
+        std::vector<TTime> DTimes;
+
+        std::size_t TripCount() const{
+            return DTrips.size();
+        }
+
+        TTime Time(std::size_t trip, std::size_t position) const{
+            return DTimes[trip * DStops.size() + position];
+        }
+    };
+
+    // How a stop was reached in a round, used to walk the journey back from the destination
+    struct SParent{
+        enum class EKind : uint8_t {None = 0, Access, Ride, Walk};
+        EKind DKind = EKind::None;
+        uint32_t DPattern = 0;
+        uint32_t DTrip = 0;
+        uint32_t DBoardPosition = 0;
+        uint32_t DAlightPosition = 0;
+        uint32_t DFromStop = 0;
+        TTime DDeparture = 0;
+    };
+
+    std::vector<TStopID> StopIDs;
+    std::unordered_map<TStopID, uint32_t> StopIndexes;
+    std::vector<SPattern> Patterns;
+    // Patterns through each stop with the position of the stop in the pattern
+    std::vector<std::vector<std::pair<uint32_t, uint32_t>>> PatternsByStop;
+    std::vector<std::vector<std::pair<uint32_t, TTime>>> Transfers;
+    std::size_t DTripCount = 0;
+
+    SImplementation(std::shared_ptr<CDSVReader> stoptimes, THopFilter hopfilter){
+        struct STrip{
+            std::string DRoute;
+            std::string DTrip;
+            std::vector<TStopID> DStops;
+            std::vector<TTime> DTimes;
+        };
+        std::vector<STrip> Trips;
+        std::unordered_map<std::string, std::size_t> TripIndexes;
+        std::vector<std::string> Row;
+        while(!stoptimes->End()){
+            if(!stoptimes->ReadRow(Row) || Row.size() < 4){
+                continue;
+            }
+            auto StopText = StringUtils::Strip(Row[2]);
+            TStopID StopID;
+            TTime Time;
+            auto Result = std::from_chars(StopText.data(), StopText.data() + StopText.size(), StopID);
+            if(Result.ec != std::errc() || Result.ptr != StopText.data() + StopText.size() || !ParseTime(StringUtils::Strip(Row[3]), Time)){
+                continue;
+            }
+            auto TripName = StringUtils::Strip(Row[1]);
+            auto Search = TripIndexes.find(TripName);
+            if(Search == TripIndexes.end()){
+                Search = TripIndexes.emplace(TripName, Trips.size()).first;
+                Trips.push_back({StringUtils::Strip(Row[0]), TripName, {}, {}});
+            }
+            Trips[Search->second].DStops.push_back(StopID);
+            Trips[Search->second].DTimes.push_back(Time);
+        }
+
+        // A trip that goes back in time cannot be ridden, one with a single stop goes nowhere
+        Trips.erase(std::remove_if(Trips.begin(), Trips.end(), [&hopfilter](const STrip &trip){
+            if(trip.DStops.size() < 2 || !std::is_sorted(trip.DTimes.begin(), trip.DTimes.end())){
+                return true;
+            }
+            for(std::size_t Index = 1; hopfilter && Index < trip.DStops.size(); Index++){
+                if(!hopfilter(trip.DRoute, trip.DStops[Index - 1], trip.DStops[Index])){
+                    return true;
+                }
+            }
+            return false;
+        }), Trips.end());
+        DTripCount = Trips.size();
+
+        for(auto &Trip : Trips){
+            StopIDs.insert(StopIDs.end(), Trip.DStops.begin(), Trip.DStops.end());
+        }
+        std::sort(StopIDs.begin(), StopIDs.end());
+        StopIDs.erase(std::unique(StopIDs.begin(), StopIDs.end()), StopIDs.end());
+        for(uint32_t Index = 0; Index < StopIDs.size(); Index++){
+            StopIndexes[StopIDs[Index]] = Index;
+        }
+        PatternsByStop.resize(StopIDs.size());
+        Transfers.resize(StopIDs.size());
+
+        // Group trips of a route by their stops, then split a group wherever a trip would overtake
+        std::map<std::pair<std::string, std::vector<uint32_t>>, std::vector<std::size_t>> TripGroups;
+        for(std::size_t Index = 0; Index < Trips.size(); Index++){
+            std::vector<uint32_t> Stops;
+            for(auto StopID : Trips[Index].DStops){
+                Stops.push_back(StopIndexes[StopID]);
+            }
+            TripGroups[std::make_pair(Trips[Index].DRoute, Stops)].push_back(Index);
+        }
+        for(auto &Group : TripGroups){
+            auto &GroupTrips = Group.second;
+            std::sort(GroupTrips.begin(), GroupTrips.end(), [&Trips](std::size_t left, std::size_t right){
+                return Trips[left].DTimes < Trips[right].DTimes;
+            });
+            auto FirstPattern = Patterns.size();
+            for(auto TripIndex : GroupTrips){
+                auto &Trip = Trips[TripIndex];
+                auto PatternIndex = FirstPattern;
+                for(; PatternIndex < Patterns.size(); PatternIndex++){
+                    auto &Pattern = Patterns[PatternIndex];
+                    auto LastTrip = Pattern.TripCount() - 1;
+                    bool Overtakes = false;
+                    for(std::size_t Position = 0; Position < Trip.DTimes.size(); Position++){
+                        if(Trip.DTimes[Position] < Pattern.Time(LastTrip, Position)){
+                            Overtakes = true;
+                            break;
+                        }
+                    }
+                    if(!Overtakes){
+                        break;
+                    }
+                }
+                if(PatternIndex == Patterns.size()){
+                    Patterns.push_back({Trip.DRoute, Group.first.second, {}, {}});
+                }
+                Patterns[PatternIndex].DTrips.push_back(Trip.DTrip);
+                Patterns[PatternIndex].DTimes.insert(Patterns[PatternIndex].DTimes.end(), Trip.DTimes.begin(), Trip.DTimes.end());
+            }
+        }
+        for(uint32_t PatternIndex = 0; PatternIndex < Patterns.size(); PatternIndex++){
+            auto &Stops = Patterns[PatternIndex].DStops;
+            for(uint32_t Position = 0; Position < Stops.size(); Position++){
+                PatternsByStop[Stops[Position]].push_back(std::make_pair(PatternIndex, Position));
+            }
+        }
+    }
+
+    bool AddTransfer(TStopID src, TStopID dest, TTime duration){
+        auto SourceIndex = StopIndexes.find(src);
+        auto DestinationIndex = StopIndexes.find(dest);
+        if(SourceIndex == StopIndexes.end() || DestinationIndex == StopIndexes.end() || duration < 0){
+            return false;
+        }
+        Transfers[SourceIndex->second].push_back(std::make_pair(DestinationIndex->second, duration));
+        return true;
+    }
+
+    // First trip at or after the given time at a position, searching trips before limit
+    static std::size_t EarliestTrip(const SPattern &pattern, std::size_t position, TTime time, std::size_t limit){
+        std::size_t Low = 0, High = limit;
+        while(Low < High){
+            auto Middle = (Low + High) / 2;
+            if(pattern.Time(Middle, position) < time){
+                Low = Middle + 1;
+            }
+            else{
+                High = Middle;
+            }
+        }
+        return Low;
+    }
+
+    TTime FindEarliestArrival(const std::vector<std::pair<TStopID, TTime>> &access, const std::vector<std::pair<TStopID, TTime>> &egress, TTime departure, std::vector<SLeg> &journey, std::size_t maxtrips) const{
+        const uint32_t NoTrip = std::numeric_limits<uint32_t>::max();
+        journey.clear();
+        auto StopCount = StopIDs.size();
+        std::vector<std::vector<TTime>> Labels(1, std::vector<TTime>(StopCount, NoArrival));
+        std::vector<std::vector<SParent>> Parents(1, std::vector<SParent>(StopCount));
+        std::vector<TTime> Best(StopCount, NoArrival);
+        std::vector<TTime> EgressTimes(StopCount, NoArrival);
+        std::vector<uint32_t> Marked;
+        std::vector<bool> IsMarked(StopCount, false);
+        auto Mark = [&Marked, &IsMarked](uint32_t stop){
+            if(!IsMarked[stop]){
+                IsMarked[stop] = true;
+                Marked.push_back(stop);
+            }
+        };
+        for(auto &Egress : egress){
+            auto Search = StopIndexes.find(Egress.first);
+            if(Search != StopIndexes.end()){
+                EgressTimes[Search->second] = std::min(EgressTimes[Search->second], Egress.second);
+            }
+        }
+        for(auto &Access : access){
+            auto Search = StopIndexes.find(Access.first);
+            if(Search != StopIndexes.end() && departure + Access.second < Labels[0][Search->second]){
+                Labels[0][Search->second] = Best[Search->second] = departure + Access.second;
+                Parents[0][Search->second].DKind = SParent::EKind::Access;
+                Mark(Search->second);
+            }
+        }
+        // Arrival at the destination so far, labels that cannot beat it are not kept
+        TTime TargetBest = NoArrival;
+        auto UpdateTarget = [&](){
+            for(auto Stop : Marked){
+                if(EgressTimes[Stop] != NoArrival){
+                    TargetBest = std::min(TargetBest, Best[Stop] + EgressTimes[Stop]);
+                }
+            }
+        };
+        UpdateTarget();
+
+        std::vector<uint32_t> QueueStart(Patterns.size(), NoTrip);
+        std::vector<uint32_t> Queue;
+        for(std::size_t Round = 1; Round <= maxtrips && !Marked.empty(); Round++){
+            Labels.push_back(Labels.back());
+            Parents.emplace_back(StopCount);
+            auto &Previous = Labels[Round - 1];
+            auto &Current = Labels[Round];
+            auto &CurrentParents = Parents[Round];
+
+            // Each pattern is scanned once from the earliest stop marked on it
+            Queue.clear();
+            for(auto Stop : Marked){
+                for(auto &PatternPosition : PatternsByStop[Stop]){
+                    if(QueueStart[PatternPosition.first] == NoTrip){
+                        Queue.push_back(PatternPosition.first);
+                        QueueStart[PatternPosition.first] = PatternPosition.second;
+                    }
+                    else{
+                        QueueStart[PatternPosition.first] = std::min(QueueStart[PatternPosition.first], PatternPosition.second);
+                    }
+                }
+                IsMarked[Stop] = false;
+            }
+            Marked.clear();
+
+            for(auto PatternIndex : Queue){
+                auto &Pattern = Patterns[PatternIndex];
+                uint32_t Trip = NoTrip;
+                uint32_t BoardPosition = 0;
+                for(uint32_t Position = QueueStart[PatternIndex]; Position < Pattern.DStops.size(); Position++){
+                    auto Stop = Pattern.DStops[Position];
+                    if(Trip != NoTrip){
+                        auto Arrival = Pattern.Time(Trip, Position);
+                        if(Arrival < Best[Stop] && Arrival < TargetBest){
+                            Current[Stop] = Best[Stop] = Arrival;
+                            CurrentParents[Stop] = {SParent::EKind::Ride, PatternIndex, Trip, BoardPosition, Position, 0, 0};
+                            Mark(Stop);
+                        }
+                    }
+                    // Catch an earlier trip if the previous round got here in time for it
+                    if(Previous[Stop] != NoArrival && (Trip == NoTrip || Previous[Stop] <= Pattern.Time(Trip, Position))){
+                        auto Earliest = EarliestTrip(Pattern, Position, Previous[Stop], Trip == NoTrip ? Pattern.TripCount() : Trip);
+                        if(Earliest < (Trip == NoTrip ? Pattern.TripCount() : Trip)){
+                            Trip = Earliest;
+                            BoardPosition = Position;
+                        }
+                    }
+                }
+                QueueStart[PatternIndex] = NoTrip;
+            }
+
+            // Walks between stops follow the rides of this round
+            auto Ridden = Marked;
+            for(auto Stop : Ridden){
+                for(auto &Transfer : Transfers[Stop]){
+                    auto Arrival = Current[Stop] + Transfer.second;
+                    if(Arrival < Best[Transfer.first] && Arrival < TargetBest){
+                        Current[Transfer.first] = Best[Transfer.first] = Arrival;
+                        CurrentParents[Transfer.first] = {SParent::EKind::Walk, 0, 0, 0, 0, Stop, Current[Stop]};
+                        Mark(Transfer.first);
+                    }
+                }
+            }
+            UpdateTarget();
+        }
+
+        // Fewest rides wins a tie
+        TTime BestArrival = NoArrival;
+        std::size_t BestRound = 0;
+        uint32_t BestStop = 0;
+        for(std::size_t Round = 0; Round < Labels.size(); Round++){
+            for(uint32_t Stop = 0; Stop < StopCount; Stop++){
+                if(Labels[Round][Stop] != NoArrival && EgressTimes[Stop] != NoArrival && Labels[Round][Stop] + EgressTimes[Stop] < BestArrival){
+                    BestArrival = Labels[Round][Stop] + EgressTimes[Stop];
+                    BestRound = Round;
+                    BestStop = Stop;
+                }
+            }
+        }
+        if(BestArrival == NoArrival){
+            return NoArrival;
+        }
+
+        auto Round = BestRound;
+        auto Stop = BestStop;
+        while(true){
+            while(Round > 0 && Parents[Round][Stop].DKind == SParent::EKind::None){
+                Round--;
+            }
+            auto &Parent = Parents[Round][Stop];
+            if(Parent.DKind == SParent::EKind::Ride){
+                auto &Pattern = Patterns[Parent.DPattern];
+                SLeg Leg{false, Pattern.DRoute, Pattern.DTrips[Parent.DTrip], {}, Pattern.Time(Parent.DTrip, Parent.DBoardPosition), Pattern.Time(Parent.DTrip, Parent.DAlightPosition)};
+                for(auto Position = Parent.DBoardPosition; Position <= Parent.DAlightPosition; Position++){
+                    Leg.DStops.push_back(StopIDs[Pattern.DStops[Position]]);
+                }
+                journey.push_back(Leg);
+                Stop = Pattern.DStops[Parent.DBoardPosition];
+                Round--;
+            }
+            else if(Parent.DKind == SParent::EKind::Walk){
+                journey.push_back({true, "", "", {StopIDs[Parent.DFromStop], StopIDs[Stop]}, Parent.DDeparture, Labels[Round][Stop]});
+                Stop = Parent.DFromStop;
+            }
+            else{
+                break;
+            }
+        }
+        std::reverse(journey.begin(), journey.end());
+        return BestArrival;
+    }
+};
+
+CRaptorTransitRouter::CRaptorTransitRouter(std::shared_ptr<CDSVReader> stoptimes, THopFilter hopfilter){
+    DImplementation = std::make_unique<SImplementation>(stoptimes, hopfilter);
+}
+
+CRaptorTransitRouter::~CRaptorTransitRouter() = default;
+
+std::size_t CRaptorTransitRouter::StopCount() const noexcept{
+    return DImplementation->StopIDs.size();
+}
+
+std::size_t CRaptorTransitRouter::TripCount() const noexcept{
+    return DImplementation->DTripCount;
+}
+
+std::size_t CRaptorTransitRouter::PatternCount() const noexcept{
+    return DImplementation->Patterns.size();
+}
+
+std::vector<CRaptorTransitRouter::TStopID> CRaptorTransitRouter::Stops() const{
+    return DImplementation->StopIDs;
+}
+
+bool CRaptorTransitRouter::AddTransfer(TStopID src, TStopID dest, TTime duration) noexcept{
+    return DImplementation->AddTransfer(src, dest, duration);
+}
+
+CRaptorTransitRouter::TTime CRaptorTransitRouter::FindEarliestArrival(const std::vector<std::pair<TStopID, TTime>> &access, const std::vector<std::pair<TStopID, TTime>> &egress, TTime departure, std::vector<SLeg> &journey, std::size_t maxtrips) const{
+    return DImplementation->FindEarliestArrival(access, egress, departure, journey, maxtrips);
+}
+
+bool CRaptorTransitRouter::ParseTime(const std::string &str, TTime &time) noexcept{
+    auto Parts = StringUtils::Split(str, ":");
+    if(Parts.size() < 2 || Parts.size() > 3){
+        return false;
+    }
+    TTime Total = 0;
+    for(std::size_t Index = 0; Index < Parts.size(); Index++){
+        auto &Part = Parts[Index];
+        TTime Value;
+        auto Result = std::from_chars(Part.data(), Part.data() + Part.size(), Value);
+        if(Part.empty() || Result.ec != std::errc() || Result.ptr != Part.data() + Part.size() || Value < 0 || (Index > 0 && (Value >= 60 || Part.size() != 2))){
+            return false;
+        }
+        Total = Total * 60 + Value;
+    }
+    if(Parts.size() == 2){
+        Total *= 60;
+    }
+    time = Total;
+    return true;
+}
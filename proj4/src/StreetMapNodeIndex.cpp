@@ -0,0 +1,191 @@
+#include "StreetMapNodeIndex.h"
+#include "GeographicUtils.h"
+#include <unordered_set>
+#include <algorithm>
+#include <queue>
+#include <cmath>
+
+struct CStreetMapNodeIndex::SImplementation{
+    // Node position in miles east and north of the south west corner of the map
+    struct SEntry{
+        double DX;
+        double DY;
+        TNodeID DID;
+    };
+
+    static constexpr double NodesPerCell = 2.0;
+    static constexpr double EarthRadiusMiles = 3959.88;
+
+    double DMinLatitude = 0.0;
+    double DMinLongitude = 0.0;
+    double DMilesPerLatitude = 0.0;
+    double DMilesPerLongitude = 0.0;
+    double DCellSize = 1.0;
+    int64_t DColumns = 0;
+    int64_t DRows = 0;
+    // Entries of cell (column, row) are in [CellStarts[row * DColumns + column], CellStarts[... + 1])
+    std::vector<uint32_t> CellStarts;
+    std::vector<SEntry> Entries;
+    std::unordered_set<TNodeID> NodeIDs;
+
+    SImplementation(std::shared_ptr<CStreetMap> streetmap, bool routableonly){
+        std::unordered_set<TNodeID> WayNodes;
+        if(routableonly){
+            for(std::size_t Index = 0; Index < streetmap->WayCount(); Index++){
+                auto Way = streetmap->WayByIndex(Index);
+                for(std::size_t NodeIndex = 0; NodeIndex < Way->NodeCount(); NodeIndex++){
+                    WayNodes.insert(Way->GetNodeID(NodeIndex));
+                }
+            }
+        }
+        std::vector<std::pair<TNodeID, TLocation>> Nodes;
+        for(std::size_t Index = 0; Index < streetmap->NodeCount(); Index++){
+            auto Node = streetmap->NodeByIndex(Index);
+            if(!routableonly || WayNodes.find(Node->ID()) != WayNodes.end()){
+                Nodes.push_back(std::make_pair(Node->ID(), Node->Location()));
+                NodeIDs.insert(Node->ID());
+            }
+        }
+        if(Nodes.empty()){
+            return;
+        }
+
+        auto MaxLatitude = DMinLatitude = Nodes.front().second.first;
+        auto MaxLongitude = DMinLongitude = Nodes.front().second.second;
+        for(auto &Node : Nodes){
+            DMinLatitude = std::min(DMinLatitude, Node.second.first);
+            MaxLatitude = std::max(MaxLatitude, Node.second.first);
+            DMinLongitude = std::min(DMinLongitude, Node.second.second);
+            MaxLongitude = std::max(MaxLongitude, Node.second.second);
+        }
+        DMilesPerLatitude = SGeographicUtils::DegreesToRadians(1.0) * EarthRadiusMiles;
+        DMilesPerLongitude = DMilesPerLatitude * std::cos(SGeographicUtils::DegreesToRadians((DMinLatitude + MaxLatitude) / 2));
+        auto Width = (MaxLongitude - DMinLongitude) * DMilesPerLongitude;
+        auto Height = (MaxLatitude - DMinLatitude) * DMilesPerLatitude;
+        auto CellCount = std::max(1.0, Nodes.size() / NodesPerCell);
+        // Square cells cover the map with about CellCount of them. A map along a line, or nearly so,
+        // is cut along its length so that a sliver of area cannot shrink the cells to nothing.
+        auto Extent = std::max(Width, Height);
+        if(Extent > 0){
+            DCellSize = std::max(std::sqrt(Width * Height / CellCount), Extent / CellCount);
+        }
+        DColumns = int64_t(Width / DCellSize) + 1;
+        DRows = int64_t(Height / DCellSize) + 1;
+
+        Entries.resize(Nodes.size());
+        CellStarts.assign(DColumns * DRows + 1, 0);
+        std::vector<int64_t> EntryCells(Nodes.size());
+        for(std::size_t Index = 0; Index < Nodes.size(); Index++){
+            Entries[Index] = {(Nodes[Index].second.second - DMinLongitude) * DMilesPerLongitude, (Nodes[Index].second.first - DMinLatitude) * DMilesPerLatitude, Nodes[Index].first};
+            EntryCells[Index] = Cell(Column(Entries[Index].DX), Row(Entries[Index].DY));
+            CellStarts[EntryCells[Index] + 1]++;
+        }
+        for(std::size_t Index = 1; Index < CellStarts.size(); Index++){
+            CellStarts[Index] += CellStarts[Index - 1];
+        }
+        auto Positions = CellStarts;
+        std::vector<SEntry> Sorted(Entries.size());
+        for(std::size_t Index = 0; Index < Entries.size(); Index++){
+            Sorted[Positions[EntryCells[Index]]++] = Entries[Index];
+        }
+        Entries.swap(Sorted);
+    }
+
+    int64_t Column(double x) const{
+        return std::clamp(int64_t(std::floor(x / DCellSize)), int64_t(0), DColumns - 1);
+    }
+
+    int64_t Row(double y) const{
+        return std::clamp(int64_t(std::floor(y / DCellSize)), int64_t(0), DRows - 1);
+    }
+
+    int64_t Cell(int64_t column, int64_t row) const{
+        return row * DColumns + column;
+    }
+
+    std::vector<TNodeID> NearestNodes(TLocation location, std::size_t count) const{
+        std::vector<TNodeID> Result;
+        if(Entries.empty() || !count){
+            return Result;
+        }
+        auto X = (location.second - DMinLongitude) * DMilesPerLongitude;
+        auto Y = (location.first - DMinLatitude) * DMilesPerLatitude;
+        auto CenterColumn = Column(X);
+        auto CenterRow = Row(Y);
+        // Farthest of the nearest nodes found so far on top
+        std::priority_queue<std::pair<double, TNodeID>> Nearest;
+        auto VisitCell = [&](int64_t column, int64_t row){
+            if(column < 0 || column >= DColumns || row < 0 || row >= DRows){
+                return;
+            }
+            auto CellIndex = Cell(column, row);
+            for(auto Index = CellStarts[CellIndex]; Index < CellStarts[CellIndex + 1]; Index++){
+                auto &Entry = Entries[Index];
+                auto Candidate = std::make_pair((Entry.DX - X) * (Entry.DX - X) + (Entry.DY - Y) * (Entry.DY - Y), Entry.DID);
+                if(Nearest.size() < count){
+                    Nearest.push(Candidate);
+                }
+                else if(Candidate < Nearest.top()){
+                    Nearest.pop();
+                    Nearest.push(Candidate);
+                }
+            }
+        };
+        for(int64_t Ring = 0; ; Ring++){
+            if(Ring == 0){
+                VisitCell(CenterColumn, CenterRow);
+            }
+            else{
+                for(auto Column = CenterColumn - Ring; Column <= CenterColumn + Ring; Column++){
+                    VisitCell(Column, CenterRow - Ring);
+                    VisitCell(Column, CenterRow + Ring);
+                }
+                for(auto Row = CenterRow - Ring + 1; Row < CenterRow + Ring; Row++){
+                    VisitCell(CenterColumn - Ring, Row);
+                    VisitCell(CenterColumn + Ring, Row);
+                }
+            }
+            if(CenterColumn - Ring <= 0 && CenterColumn + Ring >= DColumns - 1 && CenterRow - Ring <= 0 && CenterRow + Ring >= DRows - 1){
+                break;
+            }
+            // Anything in the next ring is at least as far as the edge of the block searched so far
+            auto Bound = std::min({X - (CenterColumn - Ring) * DCellSize, (CenterColumn + Ring + 1) * DCellSize - X,
+                                   Y - (CenterRow - Ring) * DCellSize, (CenterRow + Ring + 1) * DCellSize - Y});
+            if(Nearest.size() == count && Bound > 0 && Bound * Bound > Nearest.top().first){
+                break;
+            }
+        }
+        Result.resize(Nearest.size());
+        for(auto Index = Result.size(); Index > 0; Index--){
+            Result[Index - 1] = Nearest.top().second;
+            Nearest.pop();
+        }
+        return Result;
+    }
+};
+
+CStreetMapNodeIndex::CStreetMapNodeIndex(std::shared_ptr<CStreetMap> streetmap, bool routableonly){
+    DImplementation = std::make_unique<SImplementation>(streetmap, routableonly);
+}
+
+CStreetMapNodeIndex::~CStreetMapNodeIndex() = default;
+
+std::size_t CStreetMapNodeIndex::NodeCount() const noexcept{
+    return DImplementation->Entries.size();
+}
+
+bool CStreetMapNodeIndex::Contains(TNodeID id) const noexcept{
+    return DImplementation->NodeIDs.find(id) != DImplementation->NodeIDs.end();
+}
+
+CStreetMapNodeIndex::TNodeID CStreetMapNodeIndex::NearestNode(TLocation location) const noexcept{
+    auto Nearest = DImplementation->NearestNodes(location, 1);
+    if(Nearest.empty()){
+        return CStreetMap::InvalidNodeID;
+    }
+    return Nearest.front();
+}
+
+std::vector<CStreetMapNodeIndex::TNodeID> CStreetMapNodeIndex::NearestNodes(TLocation location, std::size_t count) const{
+    return DImplementation->NearestNodes(location, count);
+}
@@ -1,44 +1,67 @@
 #include "XMLReader.h"
-#include "StringUtils.h"
 #include "XMLEntity.h"
 #include <memory>
 #include <vector>
 #include <string>
 #include <expat.h>
-#include <iostream>
 #include <queue>
-#include <cstring>
-#include <unordered_map>
+#include <string_view>
 
 struct CXMLReader::SImplementation {
     std::shared_ptr<CDataSource> DSource;
     XML_Parser DParser;
     std::queue<SXMLEntity> DEntityQueue;
 
-    std::string ReaderHandleEscapeSequences(std::string str) {
-        std::string result = str;
-        // std::cout << "Original: " << result << std::endl;
-        std::unordered_map<std::string, char> escapeMap = {
+    // Expat has already decoded entity references, this only decodes any that were escaped
+    // twice. Almost no attribute contains '&', so those are left untouched without a copy.
+    static void ReaderHandleEscapeSequences(std::string &str) {
+        auto Ampersand = str.find('&');
+        if (Ampersand == std::string::npos) {
+            return;
+        }
+        static const std::pair<std::string_view, char> EscapeSequences[] = {
             {"&amp;", '&'},
             {"&lt;", '<'},
             {"&gt;", '>'},
             {"&quot;", '"'},
             {"&apos;", '\''}
         };
-        for (auto it = escapeMap.begin(); it != escapeMap.end(); ++it) {
-            // Account for the fact that the second value in the map is a char and needs to be converted to a string
-            result = StringUtils::Replace(result, it->first, std::string(1, it->second));
-            // std::cout << "Result: " << result << std::endl; 
+        // Decode in place in one left to right pass, the output never outruns the input
+        std::size_t Out = Ampersand;
+        std::size_t In = Ampersand;
+        while (In < str.size()) {
+            if (str[In] == '&') {
+                std::string_view Rest(str.data() + In, str.size() - In);
+                bool Decoded = false;
+                for (const auto &Sequence : EscapeSequences) {
+                    if (Rest.substr(0, Sequence.first.size()) == Sequence.first) {
+                        str[Out++] = Sequence.second;
+                        In += Sequence.first.size();
+                        Decoded = true;
+                        break;
+                    }
+                }
+                if (Decoded) {
+                    continue;
+                }
+            }
+            str[Out++] = str[In++];
         }
-        return result;
+        str.resize(Out);
     }
 
+    // Size of each read from the source, at most one chunk of entities is queued at a time
+    static constexpr std::size_t ChunkSize = 16384;
+    std::vector<char> DBuffer;
+    // Set once the final chunk has been handed to expat, or expat reported an error
+    bool DParseFinished = false;
+
     SImplementation(std::shared_ptr<CDataSource> src) : DSource(src) {
         DParser = XML_ParserCreate(nullptr);
         XML_SetUserData(DParser, this);
         XML_SetElementHandler(DParser, StartElementHandler, EndElementHandler);
         XML_SetCharacterDataHandler(DParser, CharacterDataHandler);
-        DEntityQueue = std::queue<SXMLEntity>();
+        DBuffer.reserve(ChunkSize);
     }
 
     ~SImplementation() {
@@ -46,80 +69,88 @@ struct CXMLReader::SImplementation {
     }
 
     static void StartElementHandler(void *userData, const XML_Char *name, const XML_Char **atts) {
-        // std::cout << "Element started" << std::endl;
-        SXMLEntity newEntity;
         auto impl = static_cast<SImplementation*>(userData);
+        impl->DEntityQueue.emplace();
+        auto &newEntity = impl->DEntityQueue.back();
         newEntity.DType = SXMLEntity::EType::StartElement;
         newEntity.DNameData = name;
-        newEntity.DAttributes = std::vector<std::pair<std::string, std::string>>();
+        int AttributeCount = 0;
+        while (atts[AttributeCount * 2]) {
+            AttributeCount++;
+        }
+        newEntity.DAttributes.reserve(AttributeCount);
         for (int i = 0; atts[i]; i += 2) {
-            char* namePtr = (char*) atts[i];
-            char* valuePtr = (char*) atts[i + 1];
-            std::string name = impl->ReaderHandleEscapeSequences(std::string(namePtr, strlen(namePtr)));
-            std::string value = impl->ReaderHandleEscapeSequences(std::string(valuePtr, strlen(valuePtr)));
-            newEntity.DAttributes.push_back(std::make_pair(name, value));
+            newEntity.DAttributes.emplace_back(atts[i], atts[i + 1]);
+            ReaderHandleEscapeSequences(newEntity.DAttributes.back().first);
+            ReaderHandleEscapeSequences(newEntity.DAttributes.back().second);
         }
-        impl->DEntityQueue.push(newEntity);
     }
 
     static void EndElementHandler(void *userData, const XML_Char *name) {
-        // std::cout << "Element ended" << std::endl;
-        SXMLEntity newEntity;
         auto impl = static_cast<SImplementation*>(userData);
+        impl->DEntityQueue.emplace();
+        auto &newEntity = impl->DEntityQueue.back();
         newEntity.DType = SXMLEntity::EType::EndElement;
         newEntity.DNameData = name;
-        impl->DEntityQueue.push(newEntity);
     }
 
     static void CharacterDataHandler(void *userData, const XML_Char *s, int len) {
-        std::string content = std::string(s, len);
-        SXMLEntity newEntity;
         auto impl = static_cast<SImplementation*>(userData);
+        // Expat splits text at line breaks and chunk boundaries, consecutive pieces are joined here
+        if (!impl->DEntityQueue.empty() && impl->DEntityQueue.back().DType == SXMLEntity::EType::CharData) {
+            impl->DEntityQueue.back().DNameData.append(s, len);
+            return;
+        }
+        impl->DEntityQueue.emplace();
+        auto &newEntity = impl->DEntityQueue.back();
         newEntity.DType = SXMLEntity::EType::CharData;
-        newEntity.DNameData = content;
-        impl->DEntityQueue.push(newEntity);
+        newEntity.DNameData.assign(s, len);
     }
 
-    bool GetLatestEntity(SXMLEntity& entity, bool skipcdata) {  
-        if (DEntityQueue.size() > 0) {
+    // Hands the next chunk of the source to expat, returns false once there is nothing left to parse
+    bool ParseChunk() {
+        if (DParseFinished) {
+            return false;
+        }
+        if (DSource->Read(DBuffer, ChunkSize)) {
+            if (!XML_Parse(DParser, DBuffer.data(), DBuffer.size(), XML_FALSE)) {
+                DParseFinished = true;
+                return true;
+            }
+        }
+        if (DSource->End()) {
+            XML_Parse(DParser, nullptr, 0, XML_TRUE);
+            DParseFinished = true;
+        }
+        return true;
+    }
+
+    // Text at the back of the queue may continue in the next chunk, so it is only
+    // ready once another entity follows it or the document is finished
+    bool FrontReady() const {
+        return DParseFinished || DEntityQueue.front().DType != SXMLEntity::EType::CharData || DEntityQueue.size() > 1;
+    }
+
+    bool ReadEntity(SXMLEntity& entity, bool skipcdata) {
+        while (true) {
             if (skipcdata) {
-                while (DEntityQueue.front().DType == SXMLEntity::EType::CharData) {
+                while (!DEntityQueue.empty() && DEntityQueue.front().DType == SXMLEntity::EType::CharData) {
                     DEntityQueue.pop();
                 }
             }
-            SXMLEntity newEntity;
-            bool charData = false;
-            while (DEntityQueue.front().DType == SXMLEntity::EType::CharData) {
-                newEntity.DType = SXMLEntity::EType::CharData;
-                auto content_front = DEntityQueue.front().DNameData;
-                DEntityQueue.pop();
-                newEntity.DNameData = newEntity.DNameData + content_front;
-                charData = true;
-            } 
-            entity = newEntity;
-            if (!charData) {
-                entity = DEntityQueue.front();
+            if (!DEntityQueue.empty() && FrontReady()) {
+                entity = std::move(DEntityQueue.front());
                 DEntityQueue.pop();
+                return true;
+            }
+            if (!ParseChunk()) {
+                return false;
             }
-            return true;
         }
-        return false;
     }
 
-    bool ReadEntity(SXMLEntity& entity, bool skipcdata) {
-        size_t bufferSize = 1024;
-        std::vector<char> Buffer(bufferSize);
-        while (!DSource->End()) {
-            if (DSource->Read(Buffer, bufferSize)) {
-                std::string content = std::string(Buffer.data(), Buffer.size());
-                // std::cout << "Buffer: " << content << std::endl;
-                if (!XML_Parse(DParser, Buffer.data(), Buffer.size(), XML_FALSE)) {
-                    break;
-                }  
-            }
-        }
-        XML_Parse(DParser, nullptr, 0, XML_TRUE);
-        return GetLatestEntity(entity, skipcdata);
+    bool End() const {
+        return DEntityQueue.empty() && (DParseFinished || DSource->End());
     }
 };
 
@@ -133,7 +164,7 @@ CXMLReader::~CXMLReader() = default;
 
 // End() function
 bool CXMLReader::End() const {
-    return DImplementation->DSource->End();
+    return DImplementation->End();
 }
 
 // ReadEntity() function
@@ -1,4 +1,5 @@
 #include "OpenStreetMap.h"
+#include "BinaryStreetMap.h"
 #include "BusSystem.h"
 #include "DSVReader.h"
 #include "DSVWriter.h"
@@ -13,6 +14,7 @@
 #include <iostream>
 #include <unordered_set>
 #include <unordered_map>
+#include <filesystem>
 
 class CArgumentParser{
     private:
@@ -57,7 +59,9 @@ int main(int argc, char *argv[]){
     std::vector<std::string> Arguments;
     const std::string OSMFilename = "city.osm";
     const std::string StopFilename = "stops.csv";
+    const std::string RouteFilename = "routes.csv";
     const std::string BusPathFilename = "buspaths.csv";
+    const std::string CompiledMapFilename = "city.bin";
 
     // Skip program name
     for(int Index = 1; Index < argc; Index++){
@@ -75,8 +79,17 @@ int main(int argc, char *argv[]){
     auto StdErr = std::make_shared<CStandardErrorDataSink>();
     auto StopReader = std::make_shared<CDSVReader>(DataFactory->CreateSource(StopFilename),',');
     auto BusPathReader = std::make_shared<CDSVReader>(DataFactory->CreateSource(BusPathFilename),',');
-    auto XMLReader = std::make_shared<CXMLReader>(DataFactory->CreateSource(OSMFilename));
-    auto StreetMap = std::make_shared<COpenStreetMap>(XMLReader);
+    // A map compiled by mapcompile from the current source files loads without parsing, otherwise the OSM file is read
+    auto CompiledMapPath = Parser.DataDirectory() + "/" + CompiledMapFilename;
+    auto SourceHash = CBinaryStreetMap::SourceHash({DataFactory->CreateSource(OSMFilename), DataFactory->CreateSource(StopFilename), DataFactory->CreateSource(RouteFilename)});
+    auto CompiledMap = std::make_shared<CBinaryStreetMap>(CompiledMapPath, SourceHash);
+    if(!CompiledMap->Loaded() && std::filesystem::exists(CompiledMapPath)){
+        std::cerr<<"Ignoring "<<CompiledMapPath<<", it was not compiled from the current source files (rerun mapcompile)"<<std::endl;
+    }
+    std::shared_ptr<CStreetMap> StreetMap = CompiledMap;
+    if(!CompiledMap->Loaded()){
+        StreetMap = std::make_shared<COpenStreetMap>(DataFactory->CreateSource(OSMFilename));
+    }
     CKMLTranslator KMLTranslator(StreetMap,StopReader,BusPathReader);
 
     for(auto &Filename : Parser.Filenames()){
@@ -0,0 +1,105 @@
+#include "BinaryStreetMap.h"
+#include "OpenStreetMap.h"
+#include "CSVBusSystem.h"
+#include "DSVReader.h"
+#include "FileDataFactory.h"
+#include "StringUtils.h"
+#include <iostream>
+#include <chrono>
+#include <vector>
+
+// Compiles the map and bus system of a data directory into the binary format read by
+// CBinaryStreetMap, the output (city.bin by default) is written to the data directory.
+// The output records a hash of city.osm, stops.csv and routes.csv, programs only use it
+// while those files are unchanged and read them directly otherwise.
+class CArgumentParser{
+    private:
+        std::string DDataDirectory;
+        std::string DOutputFilename;
+        bool DArgumentsValid;
+
+        void PrintSyntax() const;
+    public:
+        CArgumentParser(const std::vector<std::string> &args);
+
+        bool ArgumentsValid() const;
+
+        std::string DataDirectory() const;
+        std::string OutputFilename() const;
+};
+
+int main(int argc, char *argv[]){
+    std::vector<std::string> Arguments;
+    const std::string OSMFilename = "city.osm";
+    const std::string StopFilename = "stops.csv";
+    const std::string RouteFilename = "routes.csv";
+    const std::string CompiledMapFilename = "city.bin";
+
+    // Skip program name
+    for(int Index = 1; Index < argc; Index++){
+        Arguments.push_back(argv[Index]);
+    }
+
+    CArgumentParser Parser(Arguments);
+    if(!Parser.ArgumentsValid()){
+        return EXIT_FAILURE;
+    }
+    auto DataFactory = std::make_shared<CFileDataFactory>(Parser.DataDirectory());
+    auto CompileStart = std::chrono::steady_clock::now();
+    // Loaders of the compiled map compare this with the hash of the files they would otherwise read
+    auto SourceHash = CBinaryStreetMap::SourceHash({DataFactory->CreateSource(OSMFilename), DataFactory->CreateSource(StopFilename), DataFactory->CreateSource(RouteFilename)});
+    auto StopReader = std::make_shared<CDSVReader>(DataFactory->CreateSource(StopFilename),',');
+    auto RouteReader = std::make_shared<CDSVReader>(DataFactory->CreateSource(RouteFilename),',');
+    CCSVBusSystem BusSystem(StopReader, RouteReader);
+    COpenStreetMap StreetMap(DataFactory->CreateSource(OSMFilename));
+    auto OutputFilename = Parser.OutputFilename().empty() ? CompiledMapFilename : Parser.OutputFilename();
+    if(!CBinaryStreetMap::Write(StreetMap, BusSystem, SourceHash, DataFactory->CreateSink(OutputFilename))){
+        std::cerr<<"Failed to write "<<OutputFilename<<std::endl;
+        return EXIT_FAILURE;
+    }
+    auto CompileDuration = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now()-CompileStart);
+    std::cout<<"Compiled "<<StreetMap.NodeCount()<<" nodes, "<<StreetMap.WayCount()<<" ways, "<<BusSystem.StopCount()<<" stops and "<<BusSystem.RouteCount()<<" routes into "<<OutputFilename<<" in "<<CompileDuration.count()<<"ms"<<std::endl;
+
+    return EXIT_SUCCESS;
+}
+
+CArgumentParser::CArgumentParser(const std::vector<std::string> &args){
+    DDataDirectory = "./data";
+    DArgumentsValid = true;
+    for(auto &Argument : args){
+        if(Argument.find("--data") == 0){
+            auto SplitArg = StringUtils::Split(Argument,"=");
+            if(SplitArg.size() != 2 || SplitArg[0] != "--data"){
+                DArgumentsValid = false;
+                break;
+            }
+            DDataDirectory = SplitArg[1];
+        }
+        else{
+            if(!DOutputFilename.empty()){
+                DArgumentsValid = false;
+                break;
+            }
+            DOutputFilename = Argument;
+        }
+    }
+    if(!DArgumentsValid){
+        PrintSyntax();
+    }
+}
+
+void CArgumentParser::PrintSyntax() const{
+    std::cerr<<"Syntax Error: mapcompile [--data=path] [outputfile]"<<std::endl;
+}
+
+bool CArgumentParser::ArgumentsValid() const{
+    return DArgumentsValid;
+}
+
+std::string CArgumentParser::DataDirectory() const{
+    return DDataDirectory;
+}
+
+std::string CArgumentParser::OutputFilename() const{
+    return DOutputFilename;
+}
@@ -1,6 +1,7 @@
 #include "TransportationPlannerConfig.h"
 #include "DijkstraTransportationPlanner.h"
 #include "OpenStreetMap.h"
+#include "BinaryStreetMap.h"
 #include "CSVBusSystem.h"
 #include "FileDataFactory.h"
 #include "StandardDataSource.h"
@@ -13,6 +14,7 @@
 #include <chrono>
 #include <vector>
 #include <cmath>
+#include <filesystem>
 
 class CArgumentParser{
     private:
@@ -58,7 +60,9 @@ class CSpeedTest{
         void NotifyString(const std::string &str);
         void WriteStringToSink(std::shared_ptr<CDataSink> sink, const std::string &str);
     public:
-        CSpeedTest(std::shared_ptr<CDataSink> out, std::shared_ptr<CDataSink> notify, std::shared_ptr<CTransportationPlanner::SConfiguration> config);
+        // Bus paths are read from buspaths.csv and precomputed routing data is loaded from, or
+        // saved to, planner.bin in data
+        CSpeedTest(std::shared_ptr<CDataSink> out, std::shared_ptr<CDataSink> notify, std::shared_ptr<CTransportationPlanner::SConfiguration> config, std::shared_ptr<CDataFactory> data);
 
         bool RunTest(uint64_t seed, uint64_t numpoints, bool verbose);
         bool OutputResults(std::shared_ptr<CDataFactory> results, bool verbose);
@@ -69,6 +73,7 @@ int main(int argc, char *argv[]){
     const std::string OSMFilename = "city.osm";
     const std::string StopFilename = "stops.csv";
     const std::string RouteFilename = "routes.csv";
+    const std::string CompiledMapFilename = "city.bin";
 
     // Skip program name
     for(int Index = 1; Index < argc; Index++){
@@ -84,14 +89,28 @@ int main(int argc, char *argv[]){
     auto StdIn = std::make_shared<CStandardDataSource>();
     auto StdOut = std::make_shared<CStandardDataSink>();
     auto StdErr = std::make_shared<CStandardErrorDataSink>();
-    auto StopReader = std::make_shared<CDSVReader>(DataFactory->CreateSource(StopFilename),',');
-    auto RouteReader = std::make_shared<CDSVReader>(DataFactory->CreateSource(RouteFilename),',');
-    auto BusSystem = std::make_shared<CCSVBusSystem>(StopReader, RouteReader);
-    auto XMLReader = std::make_shared<CXMLReader>(DataFactory->CreateSource(OSMFilename));
-    auto StreetMap = std::make_shared<COpenStreetMap>(XMLReader);
+    std::shared_ptr<CStreetMap> StreetMap;
+    std::shared_ptr<CBusSystem> BusSystem;
+    // A map compiled by mapcompile from the current source files loads without parsing, otherwise the source files are read
+    auto CompiledMapPath = Parser.DataDirectory() + "/" + CompiledMapFilename;
+    auto SourceHash = CBinaryStreetMap::SourceHash({DataFactory->CreateSource(OSMFilename), DataFactory->CreateSource(StopFilename), DataFactory->CreateSource(RouteFilename)});
+    auto CompiledMap = std::make_shared<CBinaryStreetMap>(CompiledMapPath, SourceHash);
+    if(!CompiledMap->Loaded() && std::filesystem::exists(CompiledMapPath)){
+        std::cerr<<"Ignoring "<<CompiledMapPath<<", it was not compiled from the current source files (rerun mapcompile)"<<std::endl;
+    }
+    if(CompiledMap->Loaded()){
+        StreetMap = CompiledMap;
+        BusSystem = CompiledMap->BusSystem();
+    }
+    else{
+        auto StopReader = std::make_shared<CDSVReader>(DataFactory->CreateSource(StopFilename),',');
+        auto RouteReader = std::make_shared<CDSVReader>(DataFactory->CreateSource(RouteFilename),',');
+        BusSystem = std::make_shared<CCSVBusSystem>(StopReader, RouteReader);
+        StreetMap = std::make_shared<COpenStreetMap>(DataFactory->CreateSource(OSMFilename));
+    }
     auto PlannerConfig = std::make_shared<STransportationPlannerConfig>(StreetMap, BusSystem);
 
-    CSpeedTest SpeedTester(StdOut,StdErr,PlannerConfig);
+    CSpeedTest SpeedTester(StdOut,StdErr,PlannerConfig,DataFactory);
 
     if(SpeedTester.RunTest(Parser.Seed(),Parser.NumPoints(),Parser.Verbose())){
         if(SpeedTester.OutputResults(ResultsFactory,Parser.Verbose())){
@@ -186,15 +205,26 @@ uint64_t CArgumentParser::Seed() const{
     return DSeed;
 }
 
-CSpeedTest::CSpeedTest(std::shared_ptr<CDataSink> out, std::shared_ptr<CDataSink> notify, std::shared_ptr<CTransportationPlanner::SConfiguration> config){
+CSpeedTest::CSpeedTest(std::shared_ptr<CDataSink> out, std::shared_ptr<CDataSink> notify, std::shared_ptr<CTransportationPlanner::SConfiguration> config, std::shared_ptr<CDataFactory> data){
     const int MillisecondsPerSecond = 1000;
+    const std::string ArtifactFilename = "planner.bin";
+    const std::string BusPathFilename = "buspaths.csv";
     DOutput = out;
     DNotify = notify;
     NotifyString("Loading\n");
     auto LoadStart = std::chrono::steady_clock::now();
-    DPlanner = std::make_shared<CDijkstraTransportationPlanner>(config);
+    auto BusPathReader = std::make_shared<CDSVReader>(data->CreateSource(BusPathFilename),',');
+    auto Planner = std::make_shared<CDijkstraTransportationPlanner>(config, data->CreateSource(ArtifactFilename), BusPathReader);
     auto LoadDuration = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now()-LoadStart);
-    NotifyString("Loaded\n");
+    NotifyString(Planner->ArtifactsLoaded() ? "Loaded from " + ArtifactFilename + "\n" : "Loaded\n");
+    // Later runs on the same data skip precomputation
+    if(!Planner->ArtifactsLoaded()){
+        auto ArtifactSink = data->CreateSink(ArtifactFilename);
+        if(ArtifactSink){
+            Planner->SaveArtifacts(ArtifactSink);
+        }
+    }
+    DPlanner = Planner;
     DViolatedPrecomputeTime = config->PrecomputeTime() * MillisecondsPerSecond < LoadDuration.count();
     if(DViolatedPrecomputeTime){
         NotifyString("Violated precompute time!!!\n");
@@ -0,0 +1,169 @@
+#include <gtest/gtest.h>
+#include "BinaryStreetMap.h"
+#include "OpenStreetMap.h"
+#include "CSVBusSystem.h"
+#include "DSVReader.h"
+#include "StringDataSource.h"
+#include "FileDataSink.h"
+#include <filesystem>
+#include <fstream>
+#include <unistd.h>
+
+class CBinaryStreetMapTest : public ::testing::Test {
+    protected:
+        std::string Filename;
+        std::shared_ptr<COpenStreetMap> StreetMap;
+        std::shared_ptr<CCSVBusSystem> BusSystem;
+        uint64_t SourceHash;
+
+        void SetUp() override {
+            Filename = (std::filesystem::temp_directory_path() / ("binarystreetmaptest_" + std::to_string(getpid()) + ".bin")).string();
+            std::string xmlData = R"(
+                <osm>
+                    <node id="5" lat="38.5" lon="-121.75">
+                        <tag k="highway" v="stop"/>
+                    </node>
+                    <node id="2" lat="-0.25" lon="0.001"/>
+                    <node id="9" lat="1.0" lon="2.0"/>
+                    <node id="2" lat="3.0" lon="4.0"/>
+                    <way id="20">
+                        <nd ref="5"/>
+                        <nd ref="2"/>
+                        <tag k="name" v="A &amp; B St."/>
+                        <tag k="highway" v="residential"/>
+                    </way>
+                    <way id="10">
+                        <nd ref="2"/>
+                        <nd ref="9"/>
+                        <nd ref="5"/>
+                    </way>
+                </osm>
+            )";
+            std::string stopData = "stop_id,node_id\n22,5\n11,9";
+            std::string routeData = "route,stop_id\nA,22\nA,11\nB,11";
+            StreetMap = std::make_shared<COpenStreetMap>(std::make_shared<CStringDataSource>(xmlData));
+            auto StopReader = std::make_shared<CDSVReader>(std::make_shared<CStringDataSource>(stopData),',');
+            auto RouteReader = std::make_shared<CDSVReader>(std::make_shared<CStringDataSource>(routeData),',');
+            BusSystem = std::make_shared<CCSVBusSystem>(StopReader, RouteReader);
+            SourceHash = CBinaryStreetMap::SourceHash({std::make_shared<CStringDataSource>(xmlData), std::make_shared<CStringDataSource>(stopData), std::make_shared<CStringDataSource>(routeData)});
+            ASSERT_TRUE(CBinaryStreetMap::Write(*StreetMap, *BusSystem, SourceHash, std::make_shared<CFileDataSink>(Filename)));
+        }
+
+        void TearDown() override {
+            std::filesystem::remove(Filename);
+        }
+};
+
+TEST_F(CBinaryStreetMapTest, StreetMapTest) {
+    CBinaryStreetMap BinaryMap(Filename, SourceHash);
+    ASSERT_TRUE(BinaryMap.Loaded());
+    ASSERT_EQ(BinaryMap.NodeCount(), StreetMap->NodeCount());
+    ASSERT_EQ(BinaryMap.WayCount(), StreetMap->WayCount());
+    for (std::size_t Index = 0; Index < StreetMap->NodeCount(); Index++) {
+        auto Expected = StreetMap->NodeByIndex(Index);
+        auto Node = BinaryMap.NodeByIndex(Index);
+        ASSERT_NE(Node, nullptr);
+        EXPECT_EQ(Node->ID(), Expected->ID());
+        EXPECT_EQ(Node->Location(), Expected->Location());
+        EXPECT_EQ(Node->AttributeCount(), Expected->AttributeCount());
+    }
+    EXPECT_EQ(BinaryMap.NodeByIndex(4), nullptr);
+    // The first of two nodes with the same ID is found, like COpenStreetMap does
+    auto Node = BinaryMap.NodeByID(2);
+    ASSERT_NE(Node, nullptr);
+    EXPECT_EQ(Node->Location(), std::make_pair(-0.25, 0.001));
+    Node = BinaryMap.NodeByID(5);
+    ASSERT_NE(Node, nullptr);
+    EXPECT_EQ(Node->GetAttributeKey(0), "highway");
+    EXPECT_EQ(Node->GetAttributeKey(1), "");
+    EXPECT_TRUE(Node->HasAttribute("highway"));
+    EXPECT_EQ(Node->GetAttribute("highway"), "stop");
+    EXPECT_FALSE(Node->HasAttribute("stop"));
+    EXPECT_EQ(BinaryMap.NodeByID(3), nullptr);
+
+    auto Way = BinaryMap.WayByID(20);
+    ASSERT_NE(Way, nullptr);
+    EXPECT_EQ(Way->NodeCount(), 2);
+    EXPECT_EQ(Way->GetNodeID(0), 5);
+    EXPECT_EQ(Way->GetNodeID(1), 2);
+    EXPECT_TRUE(Way->GetNodeID(2) == CStreetMap::InvalidNodeID);
+    EXPECT_EQ(Way->AttributeCount(), 2);
+    EXPECT_EQ(Way->GetAttributeKey(0), "name");
+    EXPECT_EQ(Way->GetAttribute("name"), "A & B St.");
+    EXPECT_EQ(Way->GetAttribute("highway"), "residential");
+    EXPECT_EQ(Way->GetAttribute("oneway"), "");
+    Way = BinaryMap.WayByIndex(1);
+    ASSERT_NE(Way, nullptr);
+    EXPECT_EQ(Way->ID(), 10);
+    EXPECT_EQ(Way->NodeCount(), 3);
+    EXPECT_EQ(Way->GetNodeID(2), 5);
+    EXPECT_EQ(Way->AttributeCount(), 0);
+    EXPECT_EQ(BinaryMap.WayByID(30), nullptr);
+}
+
+TEST_F(CBinaryStreetMapTest, BusSystemTest) {
+    auto BinaryBusSystem = CBinaryStreetMap(Filename, SourceHash).BusSystem();
+    ASSERT_EQ(BinaryBusSystem->StopCount(), 2);
+    ASSERT_EQ(BinaryBusSystem->RouteCount(), 2);
+    auto Stop = BinaryBusSystem->StopByID(11);
+    ASSERT_NE(Stop, nullptr);
+    EXPECT_EQ(Stop->NodeID(), 9);
+    EXPECT_EQ(BinaryBusSystem->StopByIndex(0)->ID(), 22);
+    EXPECT_EQ(BinaryBusSystem->StopByID(33), nullptr);
+    auto Route = BinaryBusSystem->RouteByName("A");
+    ASSERT_NE(Route, nullptr);
+    EXPECT_EQ(Route->StopCount(), 2);
+    EXPECT_EQ(Route->GetStopID(0), 22);
+    EXPECT_EQ(Route->GetStopID(1), 11);
+    EXPECT_TRUE(Route->GetStopID(2) == CBusSystem::InvalidStopID);
+    EXPECT_EQ(BinaryBusSystem->RouteByIndex(1)->Name(), "B");
+    EXPECT_EQ(BinaryBusSystem->RouteByName("C"), nullptr);
+}
+
+TEST_F(CBinaryStreetMapTest, OutlivesMapTest) {
+    std::shared_ptr<CStreetMap::SWay> Way;
+    {
+        CBinaryStreetMap BinaryMap(Filename, SourceHash);
+        Way = BinaryMap.WayByID(20);
+    }
+    ASSERT_NE(Way, nullptr);
+    EXPECT_EQ(Way->GetAttribute("highway"), "residential");
+}
+
+TEST_F(CBinaryStreetMapTest, SourceHashTest) {
+    // A file compiled from other sources is not used
+    CBinaryStreetMap StaleMap(Filename, SourceHash + 1);
+    EXPECT_FALSE(StaleMap.Loaded());
+    EXPECT_EQ(StaleMap.NodeCount(), 0);
+    EXPECT_EQ(StaleMap.BusSystem()->StopCount(), 0);
+
+    auto Hash = [](const std::vector<std::string> &contents) {
+        std::vector<std::shared_ptr<CDataSource>> Sources;
+        for (auto &Content : contents) {
+            Sources.push_back(std::make_shared<CStringDataSource>(Content));
+        }
+        return CBinaryStreetMap::SourceHash(Sources);
+    };
+    EXPECT_EQ(Hash({"<osm/>", "stop_id,node_id"}), Hash({"<osm/>", "stop_id,node_id"}));
+    EXPECT_NE(Hash({"<osm/>", "stop_id,node_id"}), Hash({"<osm/>", "stop_id,node_id\n1,2"}));
+    // Moving bytes from one file to the next changes the hash
+    EXPECT_NE(Hash({"<osm/>s", "top_id"}), Hash({"<osm/>", "stop_id"}));
+}
+
+TEST_F(CBinaryStreetMapTest, InvalidFileTest) {
+    CBinaryStreetMap MissingMap(Filename + ".missing", SourceHash);
+    EXPECT_FALSE(MissingMap.Loaded());
+    EXPECT_EQ(MissingMap.NodeCount(), 0);
+    EXPECT_EQ(MissingMap.NodeByID(5), nullptr);
+    EXPECT_EQ(MissingMap.BusSystem()->StopCount(), 0);
+
+    // A truncated file is rejected rather than read past its end
+    std::filesystem::resize_file(Filename, std::filesystem::file_size(Filename) - 8);
+    CBinaryStreetMap TruncatedMap(Filename, SourceHash);
+    EXPECT_FALSE(TruncatedMap.Loaded());
+    EXPECT_EQ(TruncatedMap.WayCount(), 0);
+
+    std::ofstream(Filename) << "<osm></osm>";
+    CBinaryStreetMap TextMap(Filename, SourceHash);
+    EXPECT_FALSE(TextMap.Loaded());
+}
@@ -5,6 +5,7 @@
 #include "DSVReader.h"
 #include "CSVBusSystem.h"
 #include "BusSystemIndexer.h"
+#include "OpenStreetMap.h"
 
 TEST(CSVBusSystemIndexer, SimpleTest){
     auto InStreamStops = std::make_shared<CStringDataSource>("stop_id,node_id");
@@ -81,4 +82,133 @@ TEST(CSVBusSystemIndexer, RouteTest){
     EXPECT_TRUE(Routes.find(Route1Index) != Routes.end());
     EXPECT_TRUE(Routes.find(Route2Index) != Routes.end());
 
-}
\ No newline at end of file
+}
+TEST(CSVBusSystemIndexer, ConsecutiveStopTest){
+    auto InStreamStops = std::make_shared<CStringDataSource>(   "stop_id,node_id\n"
+                                                                "1,101\n"
+                                                                "2,102\n"
+                                                                "3,103");
+    auto InStreamRoutes = std::make_shared<CStringDataSource>(  "route,stop_id\n"
+                                                                "A,1\n"
+                                                                "A,2\n"
+                                                                "A,3\n"
+                                                                "B,3\n"
+                                                                "B,2\n"
+                                                                "C,1\n"
+                                                                "C,2\n"
+                                                                "C,4");
+    auto CSVReaderStops = std::make_shared<CDSVReader>(InStreamStops,',');
+    auto CSVReaderRoutes = std::make_shared<CDSVReader>(InStreamRoutes,',');
+    auto BusSystem = std::make_shared<CCSVBusSystem>(CSVReaderStops, CSVReaderRoutes);
+    CBusSystemIndexer BusSystemIndexer(BusSystem);
+
+    std::unordered_set< std::shared_ptr<CBusSystem::SRoute> > Routes;
+    EXPECT_TRUE(BusSystemIndexer.RoutesByNodeIDs(101,102,Routes));
+    EXPECT_EQ(Routes.size(),2);
+    EXPECT_TRUE(Routes.find(BusSystemIndexer.SortedRouteByIndex(0)) != Routes.end());
+    EXPECT_TRUE(Routes.find(BusSystemIndexer.SortedRouteByIndex(2)) != Routes.end());
+    Routes.clear();
+    EXPECT_TRUE(BusSystemIndexer.RoutesByNodeIDs(103,102,Routes));
+    ASSERT_EQ(Routes.size(),1);
+    EXPECT_EQ((*Routes.begin())->Name(),"B");
+    EXPECT_TRUE(BusSystemIndexer.RouteBetweenNodeIDs(102,103));
+    // Stops must be next to each other on the route and in its direction
+    EXPECT_FALSE(BusSystemIndexer.RouteBetweenNodeIDs(101,103));
+    EXPECT_FALSE(BusSystemIndexer.RouteBetweenNodeIDs(102,101));
+    // Stop 4 does not exist so no segment leads to it
+    EXPECT_FALSE(BusSystemIndexer.RouteBetweenNodeIDs(102,104));
+    Routes.clear();
+    EXPECT_FALSE(BusSystemIndexer.RoutesByNodeIDs(103,101,Routes));
+    EXPECT_TRUE(Routes.empty());
+}
+
+TEST(CSVBusSystemIndexer, SegmentPathTest){
+    auto StreetMap = std::make_shared<COpenStreetMap>(std::make_shared<CXMLReader>(std::make_shared<CStringDataSource>(
+                                                                "<osm>"
+                                                                "<node id=\"101\" lat=\"38.5\" lon=\"-121.7\"/>"
+                                                                "<node id=\"5\" lat=\"38.6\" lon=\"-121.7\"/>"
+                                                                "<node id=\"102\" lat=\"38.6\" lon=\"-121.8\"/>"
+                                                                "<node id=\"103\" lat=\"38.5\" lon=\"-121.8\"/>"
+                                                                "</osm>")));
+    auto InStreamStops = std::make_shared<CStringDataSource>(   "stop_id,node_id\n"
+                                                                "1,101\n"
+                                                                "2,102\n"
+                                                                "3,103");
+    auto InStreamRoutes = std::make_shared<CStringDataSource>(  "route,stop_id\n"
+                                                                "A,1\n"
+                                                                "A,2\n"
+                                                                "A,3\n"
+                                                                "B,3\n"
+                                                                "B,1");
+    auto InStreamPaths = std::make_shared<CStringDataSource>(   "src_id,dest_id,routes,path\n"
+                                                                "103,101,B,\"103,101\"\n"
+                                                                "101,102,A,\"101,5,102\"\n"
+                                                                "101,103,A,\"101,103\"\n"
+                                                                "102,103,A,\"102,6,103\"\n"
+                                                                "102,101,A,\"102,101\"\n"
+                                                                "103,101,B,\"101,103\"");
+    auto BusSystem = std::make_shared<CCSVBusSystem>(std::make_shared<CDSVReader>(InStreamStops,','), std::make_shared<CDSVReader>(InStreamRoutes,','));
+    CBusSystemIndexer BusSystemIndexer(BusSystem, std::make_shared<CDSVReader>(InStreamPaths,','), StreetMap);
+
+    // 101 to 103 and 102 to 101 are not consecutive stops, 6 is not in the map and the last path is backwards
+    ASSERT_EQ(BusSystemIndexer.SegmentPathCount(),2);
+    auto SegmentPath = BusSystemIndexer.SegmentPathByIndex(0);
+    ASSERT_TRUE(bool(SegmentPath));
+    EXPECT_EQ(SegmentPath->DSource,101);
+    EXPECT_EQ(SegmentPath->DDestination,102);
+    std::vector< CStreetMap::TNodeID > ExpectedPath = {101,5,102};
+    EXPECT_EQ(SegmentPath->DNodeIDs,ExpectedPath);
+    EXPECT_EQ(BusSystemIndexer.SegmentPathByNodeIDs(101,102),SegmentPath);
+    SegmentPath = BusSystemIndexer.SegmentPathByIndex(1);
+    ASSERT_TRUE(bool(SegmentPath));
+    EXPECT_EQ(SegmentPath->DSource,103);
+    EXPECT_EQ(SegmentPath->DDestination,101);
+    EXPECT_EQ(BusSystemIndexer.SegmentPathByNodeIDs(103,101),SegmentPath);
+    EXPECT_EQ(BusSystemIndexer.SegmentPathByIndex(2),nullptr);
+    EXPECT_EQ(BusSystemIndexer.SegmentPathByNodeIDs(102,103),nullptr);
+    EXPECT_EQ(BusSystemIndexer.SegmentPathByNodeIDs(101,103),nullptr);
+
+    // Without bus paths there are no segment paths
+    CBusSystemIndexer PlainIndexer(BusSystem);
+    EXPECT_EQ(PlainIndexer.SegmentPathCount(),0);
+    EXPECT_EQ(PlainIndexer.SegmentPathByNodeIDs(101,102),nullptr);
+}
+
+TEST(CSVBusSystemIndexer, SegmentPathMovedStopTest){
+    auto StreetMap = std::make_shared<COpenStreetMap>(std::make_shared<CXMLReader>(std::make_shared<CStringDataSource>(
+                                                                "<osm>"
+                                                                "<node id=\"201\" lat=\"38.5\" lon=\"-121.7\"/>"
+                                                                "<node id=\"5\" lat=\"38.6\" lon=\"-121.7\"/>"
+                                                                "<node id=\"102\" lat=\"38.6\" lon=\"-121.8\"/>"
+                                                                "<node id=\"103\" lat=\"38.5\" lon=\"-121.8\"/>"
+                                                                "<node id=\"203\" lat=\"38.4\" lon=\"-121.8\"/>"
+                                                                "</osm>")));
+    // Stop 1 was moved from node 201 to node 5 and stop 3 from node 203 to node 103
+    auto InStreamStops = std::make_shared<CStringDataSource>(   "stop_id,node_id\n"
+                                                                "1,5\n"
+                                                                "2,102\n"
+                                                                "3,103");
+    auto InStreamRoutes = std::make_shared<CStringDataSource>(  "route,stop_id\n"
+                                                                "A,1\n"
+                                                                "A,2\n"
+                                                                "A,3");
+    auto InStreamPaths = std::make_shared<CStringDataSource>(   "src_id,dest_id,routes,path\n"
+                                                                "201,102,A,\"201,5,102\"\n"
+                                                                "102,203,A,\"102,203\"");
+    auto BusSystem = std::make_shared<CCSVBusSystem>(std::make_shared<CDSVReader>(InStreamStops,','), std::make_shared<CDSVReader>(InStreamRoutes,','));
+    CBusSystemIndexer BusSystemIndexer(BusSystem, std::make_shared<CDSVReader>(InStreamPaths,','), StreetMap, {{201,5},{203,103}});
+
+    ASSERT_EQ(BusSystemIndexer.SegmentPathCount(),2);
+    auto SegmentPath = BusSystemIndexer.SegmentPathByNodeIDs(5,102);
+    ASSERT_TRUE(bool(SegmentPath));
+    std::vector< CStreetMap::TNodeID > ExpectedPath = {5,102};
+    EXPECT_EQ(SegmentPath->DNodeIDs,ExpectedPath);
+    SegmentPath = BusSystemIndexer.SegmentPathByNodeIDs(102,103);
+    ASSERT_TRUE(bool(SegmentPath));
+    ExpectedPath = {102,103};
+    EXPECT_EQ(SegmentPath->DNodeIDs,ExpectedPath);
+
+    // Without the moves the rows are for stop pairs the routes do not have
+    CBusSystemIndexer UnmovedIndexer(BusSystem, std::make_shared<CDSVReader>(std::make_shared<CStringDataSource>("src_id,dest_id,routes,path\n201,102,A,\"201,5,102\""),','), StreetMap);
+    EXPECT_EQ(UnmovedIndexer.SegmentPathCount(),0);
+}
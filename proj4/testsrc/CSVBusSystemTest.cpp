@@ -61,4 +61,37 @@ TEST(CSVBusSystem, RouteTest){
     EXPECT_EQ(Route1Index->GetStopID(0),1);
     EXPECT_EQ(Route1Index->GetStopID(1),2);
     EXPECT_EQ(Route1Index->GetStopID(2),1);
-}
\ No newline at end of file
+}
+TEST(CSVBusSystem, InterleavedRouteTest){
+    auto InStreamStops = std::make_shared<CStringDataSource>(   "stop_id,node_id\n"
+                                                                "1,101\n"
+                                                                "2,102\n"
+                                                                "1,103");
+    auto InStreamRoutes = std::make_shared<CStringDataSource>(  "route,stop_id\n"
+                                                                "A,1\n"
+                                                                "B,2\n"
+                                                                "A,2\n"
+                                                                "B,1");
+    auto CSVReaderStops = std::make_shared<CDSVReader>(InStreamStops,',');
+    auto CSVReaderRoutes = std::make_shared<CDSVReader>(InStreamRoutes,',');
+    CCSVBusSystem BusSystem(CSVReaderStops, CSVReaderRoutes);
+    EXPECT_EQ(BusSystem.StopCount(),3);
+    EXPECT_EQ(BusSystem.RouteCount(),2);
+    // The first stop with a repeated ID is the one found
+    auto Stop = BusSystem.StopByID(1);
+    ASSERT_TRUE(bool(Stop));
+    EXPECT_EQ(Stop,BusSystem.StopByIndex(0));
+    EXPECT_EQ(Stop->NodeID(),101);
+    EXPECT_EQ(BusSystem.StopByID(3),nullptr);
+    auto RouteA = BusSystem.RouteByName("A");
+    ASSERT_TRUE(bool(RouteA));
+    EXPECT_EQ(RouteA,BusSystem.RouteByIndex(0));
+    EXPECT_EQ(RouteA->StopCount(),2);
+    EXPECT_EQ(RouteA->GetStopID(1),2);
+    auto RouteB = BusSystem.RouteByName("B");
+    ASSERT_TRUE(bool(RouteB));
+    EXPECT_EQ(RouteB,BusSystem.RouteByIndex(1));
+    EXPECT_EQ(RouteB->GetStopID(0),2);
+    EXPECT_EQ(RouteB->GetStopID(1),1);
+    EXPECT_EQ(BusSystem.RouteByName("C"),nullptr);
+}
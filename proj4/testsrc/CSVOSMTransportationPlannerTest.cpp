@@ -2,6 +2,7 @@
 #include "XMLReader.h"
 #include "StringUtils.h"
 #include "StringDataSource.h"
+#include "StringDataSink.h"
 #include "OpenStreetMap.h"
 #include "CSVBusSystem.h"
 #include "TransportationPlannerConfig.h"
@@ -174,6 +175,545 @@ TEST(CSVOSMTransporationPlanner, FastestPathTest){
 
 }
 
+TEST(CSVOSMTransporationPlanner, BusTransferTest){
+    // Nodes 1 and 2 are a few meters apart, so walking to the next stop beats waiting at a bus stop
+    auto InStreamOSM = std::make_shared<CStringDataSource>( "<?xml version='1.0' encoding='UTF-8'?>"
+                                                            "<osm version=\"0.6\" generator=\"osmconvert 0.8.5\">"
+                                                            "<node id=\"1\" lat=\"38.5\" lon=\"-121.7\"/>"
+                                                            "<node id=\"2\" lat=\"38.5001\" lon=\"-121.7\"/>"
+                                                            "<node id=\"3\" lat=\"38.6\" lon=\"-121.7\"/>"
+                                                            "<way id=\"10\">"
+                                                            "<nd ref=\"1\"/>"
+                                                            "<nd ref=\"2\"/>"
+                                                            "<nd ref=\"3\"/>"
+                                                            "</way>"
+                                                            "</osm>");
+    auto InStreamStops = std::make_shared<CStringDataSource>("stop_id,node_id\n"
+                                                            "101,1\n"
+                                                            "102,2\n"
+                                                            "103,3"
+                                                            );
+    auto InStreamRoutes = std::make_shared<CStringDataSource>("route,stop_id\n"
+                                                             "A,101\n"
+                                                             "A,102\n"
+                                                             "A,103");
+    auto XMLReader = std::make_shared<CXMLReader>(InStreamOSM);
+    auto CSVReaderStops = std::make_shared<CDSVReader>(InStreamStops,',');
+    auto CSVReaderRoutes = std::make_shared<CDSVReader>(InStreamRoutes,',');
+    auto StreetMap = std::make_shared<COpenStreetMap>(XMLReader);
+    auto BusSystem = std::make_shared<CCSVBusSystem>(CSVReaderStops, CSVReaderRoutes);
+    // Bikes slower than walking keep the trip on foot and bus
+    auto Config = std::make_shared<STransportationPlannerConfig>(StreetMap,BusSystem,3.0,1.0);
+    CDijkstraTransportationPlanner Planner(Config);
+    // Each step is labeled with the mode actually used, the short hop is walked even though route A serves it
+    std::vector< CTransportationPlanner::TTripStep > FastestPath, ExpectedFastestPath = {{CTransportationPlanner::ETransportationMode::Walk,1},
+                                                                                        {CTransportationPlanner::ETransportationMode::Walk,2},
+                                                                                        {CTransportationPlanner::ETransportationMode::Bus,3}};
+    double WalkDistance = SGeographicUtils::HaversineDistanceInMiles(std::make_pair(38.5,-121.7),std::make_pair(38.5001,-121.7));
+    double BusDistance = SGeographicUtils::HaversineDistanceInMiles(std::make_pair(38.5001,-121.7),std::make_pair(38.6,-121.7));
+    double ExpectedTime = WalkDistance / 3.0 + (BusDistance / 25.0 + 30.0 / 3600.0);
+    EXPECT_DOUBLE_EQ(Planner.FindFastestPath(1,3,FastestPath),ExpectedTime);
+    EXPECT_EQ(FastestPath,ExpectedFastestPath);
+    std::vector< CTransportationPlanner::TTripStep > ExpectedWalkPath = {{CTransportationPlanner::ETransportationMode::Walk,2},
+                                                                        {CTransportationPlanner::ETransportationMode::Walk,1}};
+    EXPECT_DOUBLE_EQ(Planner.FindFastestPath(2,1,FastestPath),WalkDistance / 3.0);
+    EXPECT_EQ(FastestPath,ExpectedWalkPath);
+}
+
+TEST(CSVOSMTransporationPlanner, WayProfileTest){
+    // The direct way 1-2 bans bikes and has a speed limit that is not a number, the way through 3 is posted in km/h
+    auto InStreamOSM = std::make_shared<CStringDataSource>( "<?xml version='1.0' encoding='UTF-8'?>"
+                                                            "<osm version=\"0.6\" generator=\"osmconvert 0.8.5\">"
+                                                            "<node id=\"1\" lat=\"38.5\" lon=\"-121.7\"/>"
+                                                            "<node id=\"2\" lat=\"38.6\" lon=\"-121.7\"/>"
+                                                            "<node id=\"3\" lat=\"38.55\" lon=\"-121.75\"/>"
+                                                            "<way id=\"10\">"
+                                                            "<nd ref=\"1\"/>"
+                                                            "<nd ref=\"2\"/>"
+                                                            "<tag k=\"bicycle\" v=\"no\"/>"
+                                                            "<tag k=\"maxspeed\" v=\"signals\"/>"
+                                                            "</way>"
+                                                            "<way id=\"11\">"
+                                                            "<nd ref=\"1\"/>"
+                                                            "<nd ref=\"3\"/>"
+                                                            "<nd ref=\"2\"/>"
+                                                            "<tag k=\"maxspeed\" v=\"100 km/h\"/>"
+                                                            "</way>"
+                                                            "</osm>");
+    auto XMLReader = std::make_shared<CXMLReader>(InStreamOSM);
+    auto StreetMap = std::make_shared<COpenStreetMap>(XMLReader);
+    auto MakeBusSystem = [](const std::string &routes){
+        auto InStreamStops = std::make_shared<CStringDataSource>("stop_id,node_id\n"
+                                                                "101,1\n"
+                                                                "102,3\n"
+                                                                "103,2");
+        auto InStreamRoutes = std::make_shared<CStringDataSource>(routes);
+        return std::make_shared<CCSVBusSystem>(std::make_shared<CDSVReader>(InStreamStops,','), std::make_shared<CDSVReader>(InStreamRoutes,','));
+    };
+    auto Location1 = std::make_pair(38.5,-121.7), Location2 = std::make_pair(38.6,-121.7), Location3 = std::make_pair(38.55,-121.75);
+    auto Distance12 = SGeographicUtils::HaversineDistanceInMiles(Location1,Location2);
+    auto Distance13 = SGeographicUtils::HaversineDistanceInMiles(Location1,Location3);
+    auto Distance32 = SGeographicUtils::HaversineDistanceInMiles(Location3,Location2);
+    std::vector< CTransportationPlanner::TTripStep > FastestPath;
+
+    // Without a usable bus the bike has to take the detour
+    CDijkstraTransportationPlanner BikePlanner(std::make_shared<STransportationPlannerConfig>(StreetMap,MakeBusSystem("route,stop_id\nA,102")));
+    std::vector< CTransportationPlanner::TTripStep > ExpectedBikePath = {{CTransportationPlanner::ETransportationMode::Bike,1},
+                                                                        {CTransportationPlanner::ETransportationMode::Bike,3},
+                                                                        {CTransportationPlanner::ETransportationMode::Bike,2}};
+    EXPECT_DOUBLE_EQ(BikePlanner.FindFastestPath(1,2,FastestPath),(Distance13 + Distance32) / 8.0);
+    EXPECT_EQ(FastestPath,ExpectedBikePath);
+
+    // A bus on the direct way runs at the default speed limit
+    CDijkstraTransportationPlanner DirectBusPlanner(std::make_shared<STransportationPlannerConfig>(StreetMap,MakeBusSystem("route,stop_id\nA,101\nA,103")));
+    std::vector< CTransportationPlanner::TTripStep > ExpectedBusPath = {{CTransportationPlanner::ETransportationMode::Walk,1},
+                                                                       {CTransportationPlanner::ETransportationMode::Bus,2}};
+    EXPECT_DOUBLE_EQ(DirectBusPlanner.FindFastestPath(1,2,FastestPath),Distance12 / 25.0 + 30.0 / 3600.0);
+    EXPECT_EQ(FastestPath,ExpectedBusPath);
+
+    // A bus through 3 runs at 100 km/h
+    CDijkstraTransportationPlanner DetourBusPlanner(std::make_shared<STransportationPlannerConfig>(StreetMap,MakeBusSystem("route,stop_id\nA,101\nA,102\nA,103")));
+    auto BusSpeed = 100.0 / 1.609344;
+    ExpectedBusPath = {{CTransportationPlanner::ETransportationMode::Walk,1},
+                       {CTransportationPlanner::ETransportationMode::Bus,3},
+                       {CTransportationPlanner::ETransportationMode::Bus,2}};
+    EXPECT_DOUBLE_EQ(DetourBusPlanner.FindFastestPath(1,2,FastestPath),(Distance13 + Distance32) / BusSpeed + 60.0 / 3600.0);
+    EXPECT_EQ(FastestPath,ExpectedBusPath);
+}
+
+TEST(CSVOSMTransporationPlanner, OneWaySpellingTest){
+    // Each side of the triangle is one way around it, spelled a different way
+    auto InStreamOSM = std::make_shared<CStringDataSource>( "<?xml version='1.0' encoding='UTF-8'?>"
+                                                            "<osm version=\"0.6\" generator=\"osmconvert 0.8.5\">"
+                                                            "<node id=\"1\" lat=\"38.5\" lon=\"-121.7\"/>"
+                                                            "<node id=\"2\" lat=\"38.6\" lon=\"-121.7\"/>"
+                                                            "<node id=\"3\" lat=\"38.55\" lon=\"-121.75\"/>"
+                                                            "<way id=\"10\"><nd ref=\"1\"/><nd ref=\"2\"/><tag k=\"oneway\" v=\"yes\"/></way>"
+                                                            "<way id=\"11\"><nd ref=\"2\"/><nd ref=\"3\"/><tag k=\"oneway\" v=\"true\"/></way>"
+                                                            "<way id=\"12\"><nd ref=\"3\"/><nd ref=\"1\"/><tag k=\"oneway\" v=\"1\"/></way>"
+                                                            "</osm>");
+    auto StreetMap = std::make_shared<COpenStreetMap>(std::make_shared<CXMLReader>(InStreamOSM));
+    auto BusSystem = std::make_shared<CCSVBusSystem>(std::make_shared<CDSVReader>(std::make_shared<CStringDataSource>("stop_id,node_id"),','),
+                                                     std::make_shared<CDSVReader>(std::make_shared<CStringDataSource>("route,stop_id"),','));
+    CDijkstraTransportationPlanner Planner(std::make_shared<STransportationPlannerConfig>(StreetMap,BusSystem));
+    std::vector< CTransportationPlanner::TNodeID > Path;
+    std::vector< CTransportationPlanner::TNodeID > ExpectedPath = {1,2};
+    Planner.FindShortestPath(1,2,Path);
+    EXPECT_EQ(Path,ExpectedPath);
+    ExpectedPath = {2,3,1};
+    Planner.FindShortestPath(2,1,Path);
+    EXPECT_EQ(Path,ExpectedPath);
+    ExpectedPath = {3,1,2};
+    Planner.FindShortestPath(3,2,Path);
+    EXPECT_EQ(Path,ExpectedPath);
+}
+
+TEST(CSVOSMTransporationPlanner, ArtifactTest){
+    auto InStreamOSM = std::make_shared<CStringDataSource>( "<?xml version='1.0' encoding='UTF-8'?>"
+                                                            "<osm version=\"0.6\" generator=\"osmconvert 0.8.5\">"
+                                                            "<node id=\"1\" lat=\"38.5\" lon=\"-121.7\"/>"
+                                                            "<node id=\"2\" lat=\"38.6\" lon=\"-121.7\"/>"
+                                                            "<node id=\"3\" lat=\"38.6\" lon=\"-121.8\"/>"
+                                                            "<node id=\"4\" lat=\"38.5\" lon=\"-121.8\"/>"
+                                                            "<way id=\"10\">"
+                                                            "<nd ref=\"1\"/>"
+                                                            "<nd ref=\"2\"/>"
+                                                            "<nd ref=\"3\"/>"
+                                                            "<nd ref=\"4\"/>"
+                                                            "<nd ref=\"1\"/>"
+                                                            "</way>"
+                                                            "</osm>");
+    auto StreetMap = std::make_shared<COpenStreetMap>(std::make_shared<CXMLReader>(InStreamOSM));
+    auto InStreamStops = std::make_shared<CStringDataSource>("stop_id,node_id\n101,1\n103,3");
+    auto InStreamRoutes = std::make_shared<CStringDataSource>("route,stop_id\nA,101\nA,103");
+    auto BusSystem = std::make_shared<CCSVBusSystem>(std::make_shared<CDSVReader>(InStreamStops,','), std::make_shared<CDSVReader>(InStreamRoutes,','));
+    auto Config = std::make_shared<STransportationPlannerConfig>(StreetMap,BusSystem);
+    CDijkstraTransportationPlanner Planner(Config);
+    EXPECT_FALSE(Planner.ArtifactsLoaded());
+    auto Sink = std::make_shared<CStringDataSink>();
+    ASSERT_TRUE(Planner.SaveArtifacts(Sink));
+
+    CDijkstraTransportationPlanner LoadedPlanner(Config,std::make_shared<CStringDataSource>(Sink->String()));
+    EXPECT_TRUE(LoadedPlanner.ArtifactsLoaded());
+    std::vector< CTransportationPlanner::TNodeID > ShortestPath, ExpectedShortestPath;
+    std::vector< CTransportationPlanner::TTripStep > FastestPath, ExpectedFastestPath;
+    for(CTransportationPlanner::TNodeID Source = 1; Source <= 4; Source++){
+        for(CTransportationPlanner::TNodeID Dest = 1; Dest <= 4; Dest++){
+            EXPECT_EQ(LoadedPlanner.FindShortestPath(Source,Dest,ShortestPath),Planner.FindShortestPath(Source,Dest,ExpectedShortestPath));
+            EXPECT_EQ(ShortestPath,ExpectedShortestPath);
+            EXPECT_EQ(LoadedPlanner.FindFastestPath(Source,Dest,FastestPath),Planner.FindFastestPath(Source,Dest,ExpectedFastestPath));
+            EXPECT_EQ(FastestPath,ExpectedFastestPath);
+        }
+    }
+
+    // Artifacts saved with other speeds are ignored and the planner precomputes its own, walking now beats biking
+    auto FastWalkConfig = std::make_shared<STransportationPlannerConfig>(StreetMap,BusSystem,10.0);
+    CDijkstraTransportationPlanner FastWalkPlanner(FastWalkConfig,std::make_shared<CStringDataSource>(Sink->String()));
+    EXPECT_FALSE(FastWalkPlanner.ArtifactsLoaded());
+    std::vector< CTransportationPlanner::TTripStep > ExpectedWalkPath = {{CTransportationPlanner::ETransportationMode::Walk,1},
+                                                                        {CTransportationPlanner::ETransportationMode::Walk,2}};
+    EXPECT_DOUBLE_EQ(FastWalkPlanner.FindFastestPath(1,2,FastestPath),SGeographicUtils::HaversineDistanceInMiles(std::make_pair(38.5,-121.7),std::make_pair(38.6,-121.7)) / 10.0);
+    EXPECT_EQ(FastestPath,ExpectedWalkPath);
+    CDijkstraTransportationPlanner EmptyPlanner(Config,std::make_shared<CStringDataSource>(""));
+    EXPECT_FALSE(EmptyPlanner.ArtifactsLoaded());
+}
+
+TEST(CSVOSMTransporationPlanner, ScheduledPathTest){
+    // Stops 102 and 103 are a short walk apart, the rest are far from each other
+    auto InStreamOSM = std::make_shared<CStringDataSource>( "<?xml version='1.0' encoding='UTF-8'?>"
+                                                            "<osm version=\"0.6\" generator=\"osmconvert 0.8.5\">"
+                                                            "<node id=\"1\" lat=\"38.50\" lon=\"-121.7\"/>"
+                                                            "<node id=\"2\" lat=\"38.52\" lon=\"-121.7\"/>"
+                                                            "<node id=\"3\" lat=\"38.521\" lon=\"-121.7\"/>"
+                                                            "<node id=\"4\" lat=\"38.54\" lon=\"-121.7\"/>"
+                                                            "<way id=\"10\">"
+                                                            "<nd ref=\"1\"/>"
+                                                            "<nd ref=\"2\"/>"
+                                                            "<nd ref=\"3\"/>"
+                                                            "<nd ref=\"4\"/>"
+                                                            "<tag k=\"name\" v=\"Main St.\"/>"
+                                                            "</way>"
+                                                            "</osm>");
+    auto StreetMap = std::make_shared<COpenStreetMap>(std::make_shared<CXMLReader>(InStreamOSM));
+    auto InStreamStops = std::make_shared<CStringDataSource>("stop_id,node_id\n101,1\n102,2\n103,3\n104,4");
+    auto InStreamRoutes = std::make_shared<CStringDataSource>("route,stop_id\nA,101\nA,102\nB,103\nB,104");
+    auto BusSystem = std::make_shared<CCSVBusSystem>(std::make_shared<CDSVReader>(InStreamStops,','), std::make_shared<CDSVReader>(InStreamRoutes,','));
+    CDijkstraTransportationPlanner Planner(std::make_shared<STransportationPlannerConfig>(StreetMap,BusSystem));
+    auto WalkTime = (SGeographicUtils::HaversineDistanceInMiles(std::make_pair(38.50,-121.7),std::make_pair(38.52,-121.7)) +
+                    SGeographicUtils::HaversineDistanceInMiles(std::make_pair(38.52,-121.7),std::make_pair(38.521,-121.7)) +
+                    SGeographicUtils::HaversineDistanceInMiles(std::make_pair(38.521,-121.7),std::make_pair(38.54,-121.7))) / 3.0;
+    std::vector< CTransportationPlanner::TTripStep > Path;
+    std::vector< CTransportationPlanner::TTripStep > ExpectedWalkPath = {{CTransportationPlanner::ETransportationMode::Walk,1},
+                                                                        {CTransportationPlanner::ETransportationMode::Walk,2},
+                                                                        {CTransportationPlanner::ETransportationMode::Walk,3},
+                                                                        {CTransportationPlanner::ETransportationMode::Walk,4}};
+    // Without a timetable the only way is to walk
+    EXPECT_DOUBLE_EQ(Planner.FindScheduledPath(1,4,7.5,Path),WalkTime);
+    EXPECT_EQ(Path,ExpectedWalkPath);
+    EXPECT_FALSE(Planner.LoadSchedule(std::make_shared<CDSVReader>(std::make_shared<CStringDataSource>("route,trip,stop_id,time"),',')));
+
+    auto InStreamSchedule = std::make_shared<CStringDataSource>("route,trip,stop_id,time\n"
+                                                                "A,A1,101,8:00\n"
+                                                                "A,A1,102,8:10\n"
+                                                                "B,B1,103,8:20\n"
+                                                                "B,B1,104,8:30\n"
+                                                                "C,C1,101,7:55\n"
+                                                                "C,C1,104,8:05\n");
+    EXPECT_TRUE(Planner.LoadSchedule(std::make_shared<CDSVReader>(InStreamSchedule,',')));
+    // Leaving at 7:50 rides A, walks to the next stop and rides B. Route C is not in the bus system
+    // so its trip is dropped.
+    EXPECT_DOUBLE_EQ(Planner.FindScheduledPath(1,4,7.0 + 50.0 / 60.0,Path),40.0 / 60.0);
+    std::vector< CTransportationPlanner::TTripStep > ExpectedBusPath = {{CTransportationPlanner::ETransportationMode::Walk,1},
+                                                                       {CTransportationPlanner::ETransportationMode::Bus,2},
+                                                                       {CTransportationPlanner::ETransportationMode::Walk,3},
+                                                                       {CTransportationPlanner::ETransportationMode::Bus,4}};
+    EXPECT_EQ(Path,ExpectedBusPath);
+    std::vector< std::string > Description;
+    std::vector< std::string > ExpectedDescription = {"Start at 38d 30' 0\" N, 121d 42' 0\" W",
+                                                      "Take Bus A from stop 101 to stop 102",
+                                                      "Walk N along Main St. for 0.1 mi",
+                                                      "Take Bus B from stop 103 to stop 104",
+                                                      "End at 38d 32' 24\" N, 121d 42' 0\" W"};
+    EXPECT_TRUE(Planner.GetPathDescription(Path,Description));
+    EXPECT_EQ(Description,ExpectedDescription);
+    // After A has left walking is the only way again
+    EXPECT_DOUBLE_EQ(Planner.FindScheduledPath(1,4,8.25,Path),WalkTime);
+    EXPECT_EQ(Path,ExpectedWalkPath);
+    EXPECT_EQ(Planner.FindScheduledPath(1,5,7.5,Path),CPathRouter::NoPathExists);
+    EXPECT_TRUE(Path.empty());
+}
+
+TEST(CSVOSMTransporationPlanner, ScheduledOneWayWalkTest){
+    // The street from node 1 to the stop at node 2 is one way toward node 1, walkers may still take it.
+    // No single way joins the stops at nodes 2 and 3.
+    auto InStreamOSM = std::make_shared<CStringDataSource>( "<?xml version='1.0' encoding='UTF-8'?>"
+                                                            "<osm version=\"0.6\" generator=\"osmconvert 0.8.5\">"
+                                                            "<node id=\"1\" lat=\"38.500\" lon=\"-121.7\"/>"
+                                                            "<node id=\"2\" lat=\"38.505\" lon=\"-121.7\"/>"
+                                                            "<node id=\"3\" lat=\"38.705\" lon=\"-121.7\"/>"
+                                                            "<node id=\"4\" lat=\"38.605\" lon=\"-121.7\"/>"
+                                                            "<way id=\"10\">"
+                                                            "<nd ref=\"2\"/>"
+                                                            "<nd ref=\"1\"/>"
+                                                            "<tag k=\"oneway\" v=\"yes\"/>"
+                                                            "<tag k=\"name\" v=\"1st St.\"/>"
+                                                            "</way>"
+                                                            "<way id=\"11\">"
+                                                            "<nd ref=\"2\"/>"
+                                                            "<nd ref=\"4\"/>"
+                                                            "</way>"
+                                                            "<way id=\"12\">"
+                                                            "<nd ref=\"4\"/>"
+                                                            "<nd ref=\"3\"/>"
+                                                            "</way>"
+                                                            "</osm>");
+    auto StreetMap = std::make_shared<COpenStreetMap>(std::make_shared<CXMLReader>(InStreamOSM));
+    auto InStreamStops = std::make_shared<CStringDataSource>("stop_id,node_id\n102,2\n103,3");
+    auto InStreamRoutes = std::make_shared<CStringDataSource>("route,stop_id\nA,102\nA,103");
+    auto BusSystem = std::make_shared<CCSVBusSystem>(std::make_shared<CDSVReader>(InStreamStops,','), std::make_shared<CDSVReader>(InStreamRoutes,','));
+    CDijkstraTransportationPlanner Planner(std::make_shared<STransportationPlannerConfig>(StreetMap,BusSystem));
+    auto InStreamSchedule = std::make_shared<CStringDataSource>("route,trip,stop_id,time\n"
+                                                                "A,A1,102,8:00\n"
+                                                                "A,A1,103,8:20\n");
+    EXPECT_TRUE(Planner.LoadSchedule(std::make_shared<CDSVReader>(InStreamSchedule,',')));
+    std::vector< CTransportationPlanner::TNodeID > ShortestPath;
+    EXPECT_EQ(Planner.FindShortestPath(1,2,ShortestPath),CPathRouter::NoPathExists);
+
+    std::vector< CTransportationPlanner::TTripStep > Path;
+    EXPECT_DOUBLE_EQ(Planner.FindScheduledPath(1,3,7.5,Path),50.0 / 60.0);
+    std::vector< CTransportationPlanner::TTripStep > ExpectedBusPath = {{CTransportationPlanner::ETransportationMode::Walk,1},
+                                                                       {CTransportationPlanner::ETransportationMode::Walk,2},
+                                                                       {CTransportationPlanner::ETransportationMode::Bus,3}};
+    EXPECT_EQ(Path,ExpectedBusPath);
+    std::vector< std::string > Description;
+    std::vector< std::string > ExpectedDescription = {"Start at 38d 30' 0\" N, 121d 42' 0\" W",
+                                                      "Walk N along 1st St. for 0.3 mi",
+                                                      "Take Bus A from stop 102 to stop 103",
+                                                      "End at 38d 42' 18\" N, 121d 42' 0\" W"};
+    EXPECT_TRUE(Planner.GetPathDescription(Path,Description));
+    EXPECT_EQ(Description,ExpectedDescription);
+    // Walking all the way back goes against the one way street too
+    auto WalkTime = (SGeographicUtils::HaversineDistanceInMiles(std::make_pair(38.705,-121.7),std::make_pair(38.605,-121.7)) +
+                    SGeographicUtils::HaversineDistanceInMiles(std::make_pair(38.605,-121.7),std::make_pair(38.505,-121.7)) +
+                    SGeographicUtils::HaversineDistanceInMiles(std::make_pair(38.505,-121.7),std::make_pair(38.500,-121.7))) / 3.0;
+    EXPECT_DOUBLE_EQ(Planner.FindScheduledPath(3,1,7.5,Path),WalkTime);
+    std::vector< CTransportationPlanner::TTripStep > ExpectedWalkPath = {{CTransportationPlanner::ETransportationMode::Walk,3},
+                                                                        {CTransportationPlanner::ETransportationMode::Walk,4},
+                                                                        {CTransportationPlanner::ETransportationMode::Walk,2},
+                                                                        {CTransportationPlanner::ETransportationMode::Walk,1}};
+    EXPECT_EQ(Path,ExpectedWalkPath);
+}
+
+TEST(CSVOSMTransporationPlanner, BusPathTest){
+    // The stops are two street segments apart so buses only run there along a loaded path
+    auto InStreamOSM = std::make_shared<CStringDataSource>( "<?xml version='1.0' encoding='UTF-8'?>"
+                                                            "<osm version=\"0.6\" generator=\"osmconvert 0.8.5\">"
+                                                            "<node id=\"1\" lat=\"38.5\" lon=\"-121.7\"/>"
+                                                            "<node id=\"2\" lat=\"38.6\" lon=\"-121.7\"/>"
+                                                            "<node id=\"3\" lat=\"38.6\" lon=\"-121.8\"/>"
+                                                            "<way id=\"10\">"
+                                                            "<nd ref=\"1\"/>"
+                                                            "<nd ref=\"2\"/>"
+                                                            "<nd ref=\"3\"/>"
+                                                            "<tag k=\"name\" v=\"Main St.\"/>"
+                                                            "</way>"
+                                                            "</osm>");
+    auto StreetMap = std::make_shared<COpenStreetMap>(std::make_shared<CXMLReader>(InStreamOSM));
+    auto InStreamStops = std::make_shared<CStringDataSource>("stop_id,node_id\n101,1\n103,3");
+    auto InStreamRoutes = std::make_shared<CStringDataSource>("route,stop_id\nA,101\nA,103");
+    auto BusSystem = std::make_shared<CCSVBusSystem>(std::make_shared<CDSVReader>(InStreamStops,','), std::make_shared<CDSVReader>(InStreamRoutes,','));
+    auto Config = std::make_shared<STransportationPlannerConfig>(StreetMap,BusSystem);
+    auto Distance = SGeographicUtils::HaversineDistanceInMiles(std::make_pair(38.5,-121.7),std::make_pair(38.6,-121.7)) +
+                    SGeographicUtils::HaversineDistanceInMiles(std::make_pair(38.6,-121.7),std::make_pair(38.6,-121.8));
+    std::vector< CTransportationPlanner::TTripStep > FastestPath;
+
+    CDijkstraTransportationPlanner Planner(Config);
+    EXPECT_DOUBLE_EQ(Planner.FindFastestPath(1,3,FastestPath),Distance / 8.0);
+    EXPECT_EQ(FastestPath.front().first,CTransportationPlanner::ETransportationMode::Bike);
+
+    auto InStreamPaths = std::make_shared<CStringDataSource>("src_id,dest_id,routes,path\n1,3,A,\"1,2,3\"");
+    CDijkstraTransportationPlanner BusPathPlanner(Config,nullptr,std::make_shared<CDSVReader>(InStreamPaths,','));
+    EXPECT_DOUBLE_EQ(BusPathPlanner.FindFastestPath(1,3,FastestPath),Distance / 25.0 + 30.0 / 3600.0);
+    std::vector< CTransportationPlanner::TTripStep > ExpectedPath = {{CTransportationPlanner::ETransportationMode::Walk,1},
+                                                                    {CTransportationPlanner::ETransportationMode::Bus,3}};
+    EXPECT_EQ(FastestPath,ExpectedPath);
+    std::vector< std::string > Description;
+    std::vector< std::string > ExpectedDescription = {"Start at 38d 30' 0\" N, 121d 42' 0\" W",
+                                                      "Take Bus A from stop 101 to stop 103",
+                                                      "End at 38d 36' 0\" N, 121d 47' 60\" W"};
+    EXPECT_TRUE(BusPathPlanner.GetPathDescription(FastestPath,Description));
+    EXPECT_EQ(Description,ExpectedDescription);
+}
+
+TEST(CSVOSMTransporationPlanner, BusPathFallbackTest){
+    // Only the 102 to 103 leg of route A has a loaded path, and stop 104 is off every way next to node 3
+    auto InStreamOSM = std::make_shared<CStringDataSource>( "<?xml version='1.0' encoding='UTF-8'?>"
+                                                            "<osm version=\"0.6\" generator=\"osmconvert 0.8.5\">"
+                                                            "<node id=\"1\" lat=\"38.5\" lon=\"-121.7\"/>"
+                                                            "<node id=\"2\" lat=\"38.6\" lon=\"-121.7\"/>"
+                                                            "<node id=\"3\" lat=\"38.6\" lon=\"-121.8\"/>"
+                                                            "<node id=\"4\" lat=\"38.5\" lon=\"-121.8\"/>"
+                                                            "<node id=\"5\" lat=\"38.6001\" lon=\"-121.8001\"/>"
+                                                            "<way id=\"10\">"
+                                                            "<nd ref=\"1\"/>"
+                                                            "<nd ref=\"2\"/>"
+                                                            "<nd ref=\"3\"/>"
+                                                            "<nd ref=\"4\"/>"
+                                                            "</way>"
+                                                            "</osm>");
+    auto StreetMap = std::make_shared<COpenStreetMap>(std::make_shared<CXMLReader>(InStreamOSM));
+    auto InStreamStops = std::make_shared<CStringDataSource>("stop_id,node_id\n101,1\n102,2\n103,4\n104,5");
+    auto InStreamRoutes = std::make_shared<CStringDataSource>("route,stop_id\nA,101\nA,102\nA,103\nB,104\nB,101");
+    auto BusSystem = std::make_shared<CCSVBusSystem>(std::make_shared<CDSVReader>(InStreamStops,','), std::make_shared<CDSVReader>(InStreamRoutes,','));
+    auto Config = std::make_shared<STransportationPlannerConfig>(StreetMap,BusSystem);
+    auto InStreamPaths = std::make_shared<CStringDataSource>("src_id,dest_id,routes,path\n2,4,A,\"2,3,4\"\n5,1,B,\"5,3,2,1\"");
+    CDijkstraTransportationPlanner Planner(Config,nullptr,std::make_shared<CDSVReader>(InStreamPaths,','));
+    auto Distance12 = SGeographicUtils::HaversineDistanceInMiles(std::make_pair(38.5,-121.7),std::make_pair(38.6,-121.7));
+    auto Distance23 = SGeographicUtils::HaversineDistanceInMiles(std::make_pair(38.6,-121.7),std::make_pair(38.6,-121.8));
+    auto Distance34 = SGeographicUtils::HaversineDistanceInMiles(std::make_pair(38.6,-121.8),std::make_pair(38.5,-121.8));
+    std::vector< CTransportationPlanner::TTripStep > FastestPath;
+
+    // Buses still ride the street from 101 to 102, then take the loaded path to 103
+    EXPECT_DOUBLE_EQ(Planner.FindFastestPath(1,4,FastestPath),Distance12 / 25.0 + (Distance23 + Distance34) / 25.0 + 60.0 / 3600.0);
+    std::vector< CTransportationPlanner::TTripStep > ExpectedPath = {{CTransportationPlanner::ETransportationMode::Walk,1},
+                                                                    {CTransportationPlanner::ETransportationMode::Bus,2},
+                                                                    {CTransportationPlanner::ETransportationMode::Bus,4}};
+    EXPECT_EQ(FastestPath,ExpectedPath);
+    // Stop 104 was moved to node 3, its path from node 5 now starts there
+    EXPECT_DOUBLE_EQ(Planner.FindFastestPath(3,1,FastestPath),(Distance23 + Distance12) / 25.0 + 30.0 / 3600.0);
+    ExpectedPath = {{CTransportationPlanner::ETransportationMode::Walk,3},
+                    {CTransportationPlanner::ETransportationMode::Bus,1}};
+    EXPECT_EQ(FastestPath,ExpectedPath);
+}
+
+TEST(CSVOSMTransporationPlanner, BusRouteChangeTest){
+    // Route A ends where route B starts, riders change buses at stop 102 without walking
+    auto InStreamOSM = std::make_shared<CStringDataSource>( "<?xml version='1.0' encoding='UTF-8'?>"
+                                                            "<osm version=\"0.6\" generator=\"osmconvert 0.8.5\">"
+                                                            "<node id=\"1\" lat=\"38.5\" lon=\"-121.7\"/>"
+                                                            "<node id=\"2\" lat=\"38.6\" lon=\"-121.7\"/>"
+                                                            "<node id=\"3\" lat=\"38.6\" lon=\"-121.8\"/>"
+                                                            "<way id=\"10\">"
+                                                            "<nd ref=\"1\"/>"
+                                                            "<nd ref=\"2\"/>"
+                                                            "<nd ref=\"3\"/>"
+                                                            "<tag k=\"name\" v=\"Main St.\"/>"
+                                                            "</way>"
+                                                            "</osm>");
+    auto StreetMap = std::make_shared<COpenStreetMap>(std::make_shared<CXMLReader>(InStreamOSM));
+    auto InStreamStops = std::make_shared<CStringDataSource>("stop_id,node_id\n101,1\n102,2\n103,3");
+    auto InStreamRoutes = std::make_shared<CStringDataSource>("route,stop_id\nA,101\nA,102\nB,102\nB,103");
+    auto BusSystem = std::make_shared<CCSVBusSystem>(std::make_shared<CDSVReader>(InStreamStops,','), std::make_shared<CDSVReader>(InStreamRoutes,','));
+    auto Config = std::make_shared<STransportationPlannerConfig>(StreetMap,BusSystem);
+    auto InStreamPaths = std::make_shared<CStringDataSource>("src_id,dest_id,routes,path\n1,2,A,\"1,2\"\n2,3,B,\"2,3\"");
+    CDijkstraTransportationPlanner Planner(Config,nullptr,std::make_shared<CDSVReader>(InStreamPaths,','));
+    auto Distance = SGeographicUtils::HaversineDistanceInMiles(std::make_pair(38.5,-121.7),std::make_pair(38.6,-121.7)) +
+                    SGeographicUtils::HaversineDistanceInMiles(std::make_pair(38.6,-121.7),std::make_pair(38.6,-121.8));
+    std::vector< CTransportationPlanner::TTripStep > FastestPath;
+    EXPECT_DOUBLE_EQ(Planner.FindFastestPath(1,3,FastestPath),Distance / 25.0 + 60.0 / 3600.0);
+    std::vector< CTransportationPlanner::TTripStep > ExpectedPath = {{CTransportationPlanner::ETransportationMode::Walk,1},
+                                                                    {CTransportationPlanner::ETransportationMode::Bus,2},
+                                                                    {CTransportationPlanner::ETransportationMode::Bus,3}};
+    EXPECT_EQ(FastestPath,ExpectedPath);
+    std::vector< std::string > Description;
+    std::vector< std::string > ExpectedDescription = {"Start at 38d 30' 0\" N, 121d 42' 0\" W",
+                                                      "Take Bus A from stop 101 to stop 102",
+                                                      "Take Bus B from stop 102 to stop 103",
+                                                      "End at 38d 36' 0\" N, 121d 47' 60\" W"};
+    EXPECT_TRUE(Planner.GetPathDescription(FastestPath,Description));
+    EXPECT_EQ(Description,ExpectedDescription);
+}
+
+TEST(CSVOSMTransporationPlanner, NearestNodeTest){
+    // Stops sit on nodes beside the street rather than on it
+    auto InStreamOSM = std::make_shared<CStringDataSource>( "<?xml version='1.0' encoding='UTF-8'?>"
+                                                            "<osm version=\"0.6\" generator=\"osmconvert 0.8.5\">"
+                                                            "<node id=\"1\" lat=\"38.5\" lon=\"-121.7\"/>"
+                                                            "<node id=\"2\" lat=\"38.6\" lon=\"-121.7\"/>"
+                                                            "<node id=\"3\" lat=\"38.5001\" lon=\"-121.7001\"/>"
+                                                            "<node id=\"4\" lat=\"38.6001\" lon=\"-121.7001\"/>"
+                                                            "<way id=\"10\">"
+                                                            "<nd ref=\"1\"/>"
+                                                            "<nd ref=\"2\"/>"
+                                                            "<tag k=\"name\" v=\"Main St.\"/>"
+                                                            "</way>"
+                                                            "</osm>");
+    auto StreetMap = std::make_shared<COpenStreetMap>(std::make_shared<CXMLReader>(InStreamOSM));
+    auto InStreamStops = std::make_shared<CStringDataSource>("stop_id,node_id\n101,3\n102,4");
+    auto InStreamRoutes = std::make_shared<CStringDataSource>("route,stop_id\nA,101\nA,102");
+    auto BusSystem = std::make_shared<CCSVBusSystem>(std::make_shared<CDSVReader>(InStreamStops,','), std::make_shared<CDSVReader>(InStreamRoutes,','));
+    auto Config = std::make_shared<STransportationPlannerConfig>(StreetMap,BusSystem);
+    CDijkstraTransportationPlanner Planner(Config);
+
+    EXPECT_EQ(Planner.FindNearestNode(std::make_pair(38.59,-121.71)),2);
+    EXPECT_EQ(Planner.FindNearestNode(std::make_pair(38.5001,-121.7001)),1);
+    std::vector< CTransportationPlanner::TNodeID > ExpectedNodes = {1,2};
+    EXPECT_EQ(Planner.FindNearestNodes(std::make_pair(38.5001,-121.7001),5),ExpectedNodes);
+
+    // The bus runs between the street nodes the stops snap to
+    auto Distance = SGeographicUtils::HaversineDistanceInMiles(std::make_pair(38.5,-121.7),std::make_pair(38.6,-121.7));
+    std::vector< CTransportationPlanner::TTripStep > FastestPath;
+    EXPECT_DOUBLE_EQ(Planner.FindFastestPath(1,2,FastestPath),Distance / 25.0 + 30.0 / 3600.0);
+    std::vector< CTransportationPlanner::TTripStep > ExpectedPath = {{CTransportationPlanner::ETransportationMode::Walk,1},
+                                                                    {CTransportationPlanner::ETransportationMode::Bus,2}};
+    EXPECT_EQ(FastestPath,ExpectedPath);
+    std::vector< std::string > Description;
+    EXPECT_TRUE(Planner.GetPathDescription(FastestPath,Description));
+    ASSERT_EQ(Description.size(),3);
+    EXPECT_EQ(Description[1],"Take Bus A from stop 101 to stop 102");
+}
+
+TEST(CSVOSMTransporationPlanner, DistanceMatrixTest){
+    auto InStreamOSM = std::make_shared<CStringDataSource>( "<?xml version='1.0' encoding='UTF-8'?>"
+                                                            "<osm version=\"0.6\" generator=\"osmconvert 0.8.5\">"
+                                                            "<node id=\"1\" lat=\"38.5\" lon=\"-121.7\"/>"
+                                                            "<node id=\"2\" lat=\"38.6\" lon=\"-121.7\"/>"
+                                                            "<node id=\"3\" lat=\"38.6\" lon=\"-121.8\"/>"
+                                                            "<node id=\"4\" lat=\"38.5\" lon=\"-121.8\"/>"
+                                                            "<node id=\"5\" lat=\"38.7\" lon=\"-121.8\"/>"
+                                                            "<way id=\"10\">"
+                                                            "<nd ref=\"1\"/>"
+                                                            "<nd ref=\"2\"/>"
+                                                            "<nd ref=\"3\"/>"
+                                                            "<nd ref=\"4\"/>"
+                                                            "</way>"
+                                                            "<way id=\"11\">"
+                                                            "<nd ref=\"4\"/>"
+                                                            "<nd ref=\"1\"/>"
+                                                            "<tag k=\"oneway\" v=\"yes\"/>"
+                                                            "</way>"
+                                                            "</osm>");
+    auto StreetMap = std::make_shared<COpenStreetMap>(std::make_shared<CXMLReader>(InStreamOSM));
+    auto InStreamStops = std::make_shared<CStringDataSource>("stop_id,node_id\n101,1\n103,3");
+    auto InStreamRoutes = std::make_shared<CStringDataSource>("route,stop_id\nA,101\nA,103");
+    auto BusSystem = std::make_shared<CCSVBusSystem>(std::make_shared<CDSVReader>(InStreamStops,','), std::make_shared<CDSVReader>(InStreamRoutes,','));
+    auto Config = std::make_shared<STransportationPlannerConfig>(StreetMap,BusSystem);
+    CDijkstraTransportationPlanner Planner(Config);
+
+    // Node 5 is on no way and node 9 is not in the map
+    std::vector< CTransportationPlanner::TNodeID > Sources = {1,4,3,5,9}, Targets = {4,1,2,1,5};
+    auto ShortestMatrix = Planner.FindDistanceMatrix(Sources,Targets,CTransportationPlanner::EDistanceMode::Shortest);
+    auto FastestMatrix = Planner.FindDistanceMatrix(Sources,Targets,CTransportationPlanner::EDistanceMode::Fastest);
+    // The interface's default runs a query per pair
+    auto DefaultShortestMatrix = Planner.CTransportationPlanner::FindDistanceMatrix(Sources,Targets,CTransportationPlanner::EDistanceMode::Shortest);
+    auto DefaultFastestMatrix = Planner.CTransportationPlanner::FindDistanceMatrix(Sources,Targets,CTransportationPlanner::EDistanceMode::Fastest);
+    ASSERT_EQ(ShortestMatrix.size(),Sources.size());
+    ASSERT_EQ(FastestMatrix.size(),Sources.size());
+    ASSERT_EQ(DefaultShortestMatrix.size(),Sources.size());
+    ASSERT_EQ(DefaultFastestMatrix.size(),Sources.size());
+    std::vector< CTransportationPlanner::TNodeID > ShortestPath;
+    std::vector< CTransportationPlanner::TTripStep > FastestPath;
+    for(std::size_t Row = 0; Row < Sources.size(); Row++){
+        ASSERT_EQ(ShortestMatrix[Row].size(),Targets.size());
+        ASSERT_EQ(FastestMatrix[Row].size(),Targets.size());
+        ASSERT_EQ(DefaultShortestMatrix[Row].size(),Targets.size());
+        ASSERT_EQ(DefaultFastestMatrix[Row].size(),Targets.size());
+        for(std::size_t Column = 0; Column < Targets.size(); Column++){
+            auto Shortest = Planner.FindShortestPath(Sources[Row],Targets[Column],ShortestPath);
+            auto Fastest = Planner.FindFastestPath(Sources[Row],Targets[Column],FastestPath);
+            EXPECT_EQ(DefaultShortestMatrix[Row][Column],Shortest);
+            EXPECT_EQ(DefaultFastestMatrix[Row][Column],Fastest);
+            if(Shortest == CPathRouter::NoPathExists){
+                EXPECT_EQ(ShortestMatrix[Row][Column],CPathRouter::NoPathExists);
+            }
+            else{
+                EXPECT_NEAR(ShortestMatrix[Row][Column],Shortest,1e-9);
+            }
+            if(Fastest == CPathRouter::NoPathExists){
+                EXPECT_EQ(FastestMatrix[Row][Column],CPathRouter::NoPathExists);
+            }
+            else{
+                EXPECT_NEAR(FastestMatrix[Row][Column],Fastest,1e-9);
+            }
+        }
+    }
+    // The one way street is only a shortcut from 4 to 1
+    EXPECT_LT(ShortestMatrix[1][1],ShortestMatrix[0][0]);
+    EXPECT_EQ(ShortestMatrix[3][0],CPathRouter::NoPathExists);
+    EXPECT_EQ(FastestMatrix[4][1],CPathRouter::NoPathExists);
+    EXPECT_EQ(ShortestMatrix[0][1],0.0);
+}
+
 TEST(CSVOSMTransporationPlanner, PathDescription){
     auto InStreamOSM = std::make_shared<CStringDataSource>( "<?xml version='1.0' encoding='UTF-8'?>"
                                                             "<osm version=\"0.6\" generator=\"osmconvert 0.8.5\">"
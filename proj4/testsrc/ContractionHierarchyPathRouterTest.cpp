@@ -0,0 +1,242 @@
+#include <gtest/gtest.h>
+#include "ContractionHierarchyPathRouter.h"
+#include "DijkstraPathRouter.h"
+#include "StringDataSink.h"
+#include "StringDataSource.h"
+#include <random>
+#include <cstring>
+
+TEST(ContractionHierarchyPathRouter, SimpleTest){
+    CContractionHierarchyPathRouter PathRouter;
+    std::vector< CPathRouter::TVertexID > Path;
+    EXPECT_EQ(PathRouter.VertexCount(),0);
+    EXPECT_TRUE(PathRouter.Precompute(std::chrono::steady_clock::now() + std::chrono::seconds(1)));
+    EXPECT_TRUE(PathRouter.Contracted());
+    EXPECT_EQ(PathRouter.FindShortestPath(0,1,Path),CPathRouter::NoPathExists);
+    EXPECT_TRUE(Path.empty());
+}
+
+TEST(ContractionHierarchyPathRouter, ShortestPathTest){
+    CContractionHierarchyPathRouter PathRouter;
+    std::vector< CPathRouter::TVertexID > Vertices;
+    for(int Index = 0; Index < 6; Index++){
+        Vertices.push_back(PathRouter.AddVertex(Index));
+    }
+    EXPECT_EQ(std::any_cast<int>(PathRouter.GetVertexTag(Vertices[3])),3);
+    EXPECT_TRUE(PathRouter.AddEdge(Vertices[0],Vertices[1],4.0));
+    EXPECT_TRUE(PathRouter.AddEdge(Vertices[0],Vertices[2],1.0));
+    EXPECT_TRUE(PathRouter.AddEdge(Vertices[2],Vertices[1],2.0));
+    EXPECT_TRUE(PathRouter.AddEdge(Vertices[1],Vertices[3],1.0));
+    EXPECT_TRUE(PathRouter.AddEdge(Vertices[3],Vertices[4],3.0,true));
+    EXPECT_FALSE(PathRouter.AddEdge(Vertices[3],6,1.0));
+    std::vector< CPathRouter::TVertexID > Path, ExpectedPath = {0,2,1,3,4};
+    // Queries before Precompute are answered without the hierarchy
+    EXPECT_EQ(PathRouter.FindShortestPath(Vertices[0],Vertices[4],Path),7.0);
+    EXPECT_EQ(Path,ExpectedPath);
+    EXPECT_FALSE(PathRouter.Contracted());
+    EXPECT_TRUE(PathRouter.Precompute(std::chrono::steady_clock::now() + std::chrono::seconds(1)));
+    EXPECT_TRUE(PathRouter.Contracted());
+    EXPECT_EQ(PathRouter.FindShortestPath(Vertices[0],Vertices[4],Path),7.0);
+    EXPECT_EQ(Path,ExpectedPath);
+    ExpectedPath = {4,3};
+    EXPECT_EQ(PathRouter.FindShortestPath(Vertices[4],Vertices[3],Path),3.0);
+    EXPECT_EQ(Path,ExpectedPath);
+    EXPECT_EQ(PathRouter.FindShortestPath(Vertices[4],Vertices[0],Path),CPathRouter::NoPathExists);
+    EXPECT_TRUE(Path.empty());
+    EXPECT_EQ(PathRouter.FindShortestPath(Vertices[5],Vertices[5],Path),0.0);
+    EXPECT_EQ(Path,std::vector< CPathRouter::TVertexID >{5});
+    // Changing the graph drops the hierarchy until the next Precompute
+    EXPECT_TRUE(PathRouter.AddEdge(Vertices[0],Vertices[4],2.0));
+    EXPECT_FALSE(PathRouter.Contracted());
+    ExpectedPath = {0,4};
+    EXPECT_EQ(PathRouter.FindShortestPath(Vertices[0],Vertices[4],Path),2.0);
+    EXPECT_EQ(Path,ExpectedPath);
+}
+
+TEST(ContractionHierarchyPathRouter, DeadlineTest){
+    CContractionHierarchyPathRouter PathRouter;
+    for(int Index = 0; Index < 200; Index++){
+        PathRouter.AddVertex(Index);
+    }
+    for(int Index = 1; Index < 200; Index++){
+        PathRouter.AddEdge(Index - 1,Index,1.0,true);
+    }
+    // A deadline that has already passed leaves the router answering with plain Dijkstra
+    EXPECT_FALSE(PathRouter.Precompute(std::chrono::steady_clock::now() - std::chrono::seconds(1)));
+    EXPECT_FALSE(PathRouter.Contracted());
+    EXPECT_LT(PathRouter.PrecomputeProgress(),1.0);
+    std::vector< CPathRouter::TVertexID > Path;
+    EXPECT_EQ(PathRouter.FindShortestPath(0,199,Path),199.0);
+    EXPECT_EQ(Path.size(),200);
+    // The next call picks up where the last one stopped and returns as soon as it is done
+    auto Start = std::chrono::steady_clock::now();
+    EXPECT_TRUE(PathRouter.Precompute(Start + std::chrono::seconds(30)));
+    EXPECT_LT(std::chrono::steady_clock::now() - Start,std::chrono::seconds(5));
+    EXPECT_TRUE(PathRouter.Contracted());
+    EXPECT_EQ(PathRouter.PrecomputeProgress(),1.0);
+    EXPECT_EQ(PathRouter.FindShortestPath(0,199,Path),199.0);
+    EXPECT_EQ(Path.size(),200);
+}
+
+TEST(ContractionHierarchyPathRouter, SaveLoadTest){
+    auto BuildRouter = [](double lastWeight){
+        auto PathRouter = std::make_shared<CContractionHierarchyPathRouter>();
+        for(int Index = 0; Index < 50; Index++){
+            PathRouter->AddVertex(Index);
+        }
+        for(int Index = 1; Index < 50; Index++){
+            PathRouter->AddEdge(Index - 1,Index,Index == 49 ? lastWeight : 1.0,true);
+        }
+        return PathRouter;
+    };
+    auto PathRouter = BuildRouter(1.0);
+    auto Sink = std::make_shared<CStringDataSink>();
+    // Nothing to save before Precompute
+    EXPECT_FALSE(PathRouter->SaveHierarchy(Sink));
+    ASSERT_TRUE(PathRouter->Precompute(std::chrono::steady_clock::now() + std::chrono::seconds(10)));
+    ASSERT_TRUE(PathRouter->SaveHierarchy(Sink));
+
+    auto LoadedRouter = BuildRouter(1.0);
+    EXPECT_TRUE(LoadedRouter->LoadHierarchy(std::make_shared<CStringDataSource>(Sink->String())));
+    EXPECT_TRUE(LoadedRouter->Contracted());
+    EXPECT_EQ(LoadedRouter->PrecomputeProgress(),1.0);
+    std::vector< CPathRouter::TVertexID > Path, ExpectedPath;
+    EXPECT_EQ(LoadedRouter->FindShortestPath(49,0,Path),PathRouter->FindShortestPath(49,0,ExpectedPath));
+    EXPECT_EQ(Path,ExpectedPath);
+    EXPECT_EQ(Path.size(),50);
+
+    // A hierarchy saved for another graph, or cut short, is rejected
+    auto OtherRouter = BuildRouter(2.0);
+    EXPECT_FALSE(OtherRouter->LoadHierarchy(std::make_shared<CStringDataSource>(Sink->String())));
+    EXPECT_FALSE(OtherRouter->Contracted());
+    EXPECT_EQ(OtherRouter->FindShortestPath(0,49,Path),50.0);
+    auto TruncatedRouter = BuildRouter(1.0);
+    EXPECT_FALSE(TruncatedRouter->LoadHierarchy(std::make_shared<CStringDataSource>(Sink->String().substr(0,Sink->String().size() - 1))));
+    EXPECT_FALSE(TruncatedRouter->Contracted());
+    EXPECT_FALSE(TruncatedRouter->LoadHierarchy(std::make_shared<CStringDataSource>("")));
+
+    // Shortcuts that bypass a vertex without the edges to unpack them fail the query instead of crashing
+    auto Damaged = Sink->String();
+    std::size_t Position = 16;
+    auto ReadCount = [&Damaged](std::size_t position){
+        uint64_t Count;
+        std::memcpy(&Count, Damaged.data() + position, sizeof(Count));
+        return Count;
+    };
+    std::size_t Shortcuts = 0;
+    for(int Half = 0; Half < 2; Half++){
+        Position += 8 + ReadCount(Position) * sizeof(std::size_t);
+        auto EdgeCount = ReadCount(Position);
+        Position += 8;
+        for(uint64_t Index = 0; Index < EdgeCount; Index++, Position += 24){
+            std::size_t Middle, Bypassed = 0;
+            std::memcpy(&Middle, Damaged.data() + Position + 16, sizeof(Middle));
+            if(Middle != CPathRouter::InvalidVertexID){
+                std::memcpy(&Damaged[Position + 16], &Bypassed, sizeof(Bypassed));
+                Shortcuts++;
+            }
+        }
+    }
+    ASSERT_GT(Shortcuts,0);
+    auto DamagedRouter = BuildRouter(1.0);
+    ASSERT_TRUE(DamagedRouter->LoadHierarchy(std::make_shared<CStringDataSource>(Damaged)));
+    EXPECT_EQ(DamagedRouter->FindShortestPath(49,0,Path),CPathRouter::NoPathExists);
+    EXPECT_TRUE(Path.empty());
+}
+
+TEST(ContractionHierarchyPathRouter, MatchesDijkstraTest){
+    // Random road-like graph, a jittered grid with a mix of one and two way edges
+    const std::size_t Width = 20;
+    std::mt19937 Generator(1234);
+    std::uniform_real_distribution<double> WeightDistribution(1.0, 3.0);
+    std::uniform_int_distribution<int> KindDistribution(0, 5);
+    CContractionHierarchyPathRouter PathRouter;
+    CDijkstraPathRouter ReferenceRouter;
+    for(std::size_t Index = 0; Index < Width * Width; Index++){
+        PathRouter.AddVertex(Index);
+        ReferenceRouter.AddVertex(Index);
+    }
+    auto AddEdge = [&](CPathRouter::TVertexID src, CPathRouter::TVertexID dest){
+        auto Weight = WeightDistribution(Generator);
+        auto Kind = KindDistribution(Generator);
+        if(Kind == 0){
+            return;
+        }
+        bool Bidir = Kind > 2;
+        PathRouter.AddEdge(src,dest,Weight,Bidir);
+        ReferenceRouter.AddEdge(src,dest,Weight,Bidir);
+    };
+    for(std::size_t Row = 0; Row < Width; Row++){
+        for(std::size_t Col = 0; Col < Width; Col++){
+            auto Vertex = Row * Width + Col;
+            if(Col + 1 < Width){
+                AddEdge(Vertex,Vertex + 1);
+            }
+            if(Row + 1 < Width){
+                AddEdge(Vertex + Width,Vertex);
+            }
+        }
+    }
+    ASSERT_TRUE(PathRouter.Precompute(std::chrono::steady_clock::now() + std::chrono::seconds(10)));
+    std::vector< CPathRouter::TVertexID > Path, ReferencePath;
+    for(CPathRouter::TVertexID Source = 0; Source < Width * Width; Source += 13){
+        for(CPathRouter::TVertexID Dest = 0; Dest < Width * Width; Dest += 17){
+            auto Expected = ReferenceRouter.FindShortestPath(Source,Dest,ReferencePath);
+            auto Actual = PathRouter.FindShortestPath(Source,Dest,Path);
+            if(Expected == CPathRouter::NoPathExists){
+                EXPECT_EQ(Actual,CPathRouter::NoPathExists);
+                EXPECT_TRUE(Path.empty());
+                continue;
+            }
+            EXPECT_NEAR(Actual,Expected,1e-9);
+            ASSERT_FALSE(Path.empty());
+            EXPECT_EQ(Path.front(),Source);
+            EXPECT_EQ(Path.back(),Dest);
+        }
+    }
+}
+
+TEST(ContractionHierarchyPathRouter, DistancesTest){
+    // Random grid like MatchesDijkstraTest, compared entry by entry before and after contraction
+    const std::size_t Width = 15;
+    std::mt19937 Generator(99);
+    std::uniform_real_distribution<double> WeightDistribution(1.0, 3.0);
+    std::uniform_int_distribution<int> KindDistribution(0, 5);
+    CContractionHierarchyPathRouter PathRouter;
+    CDijkstraPathRouter ReferenceRouter;
+    for(std::size_t Index = 0; Index < Width * Width; Index++){
+        PathRouter.AddVertex(Index);
+        ReferenceRouter.AddVertex(Index);
+    }
+    for(std::size_t Vertex = 0; Vertex < Width * Width; Vertex++){
+        for(auto Neighbor : {Vertex + 1, Vertex + Width}){
+            auto Weight = WeightDistribution(Generator);
+            auto Kind = KindDistribution(Generator);
+            if(Kind == 0 || Neighbor >= Width * Width || (Neighbor == Vertex + 1 && Neighbor % Width == 0)){
+                continue;
+            }
+            PathRouter.AddEdge(Vertex,Neighbor,Weight,Kind > 2);
+            ReferenceRouter.AddEdge(Vertex,Neighbor,Weight,Kind > 2);
+        }
+    }
+    std::vector< CPathRouter::TVertexID > Sources = {0,7,7,112,224,300}, Dests = {224,0,58,112,131,7};
+    std::vector< CPathRouter::TVertexID > Path;
+    std::vector< std::vector<double> > Distances;
+    for(int Pass = 0; Pass < 2; Pass++){
+        PathRouter.FindDistances(Sources,Dests,Distances);
+        ASSERT_EQ(Distances.size(),Sources.size());
+        for(std::size_t Row = 0; Row < Sources.size(); Row++){
+            ASSERT_EQ(Distances[Row].size(),Dests.size());
+            for(std::size_t Column = 0; Column < Dests.size(); Column++){
+                auto Expected = ReferenceRouter.FindShortestPath(Sources[Row],Dests[Column],Path);
+                if(Expected == CPathRouter::NoPathExists){
+                    EXPECT_EQ(Distances[Row][Column],CPathRouter::NoPathExists);
+                }
+                else{
+                    EXPECT_NEAR(Distances[Row][Column],Expected,1e-9);
+                }
+            }
+        }
+        ASSERT_TRUE(PathRouter.Precompute(std::chrono::steady_clock::now() + std::chrono::seconds(10)));
+    }
+}
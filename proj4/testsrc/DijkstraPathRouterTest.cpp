@@ -0,0 +1,266 @@
+#include <gtest/gtest.h>
+#include "DijkstraPathRouter.h"
+
+TEST(DijkstraPathRouter, SimpleTest){
+    CDijkstraPathRouter PathRouter;
+    std::vector< CPathRouter::TVertexID > Path;
+    EXPECT_EQ(PathRouter.VertexCount(),0);
+    EXPECT_EQ(PathRouter.FindShortestPath(0,1,Path),CPathRouter::NoPathExists);
+    EXPECT_TRUE(Path.empty());
+}
+
+TEST(DijkstraPathRouter, VertexTest){
+    CDijkstraPathRouter PathRouter;
+    auto Vertex0 = PathRouter.AddVertex(std::string("A"));
+    auto Vertex1 = PathRouter.AddVertex(42);
+    EXPECT_EQ(Vertex0,0);
+    EXPECT_EQ(Vertex1,1);
+    EXPECT_EQ(PathRouter.VertexCount(),2);
+    EXPECT_EQ(std::any_cast<std::string>(PathRouter.GetVertexTag(Vertex0)),"A");
+    EXPECT_EQ(std::any_cast<int>(PathRouter.GetVertexTag(Vertex1)),42);
+    EXPECT_FALSE(PathRouter.GetVertexTag(2).has_value());
+    EXPECT_FALSE(PathRouter.AddEdge(Vertex0,2,1.0));
+}
+
+TEST(DijkstraPathRouter, ShortestPathTest){
+    CDijkstraPathRouter PathRouter;
+    std::vector< CPathRouter::TVertexID > Vertices;
+    for(int Index = 0; Index < 5; Index++){
+        Vertices.push_back(PathRouter.AddVertex(Index));
+    }
+    EXPECT_TRUE(PathRouter.AddEdge(Vertices[0],Vertices[1],4.0));
+    EXPECT_TRUE(PathRouter.AddEdge(Vertices[0],Vertices[2],1.0));
+    EXPECT_TRUE(PathRouter.AddEdge(Vertices[2],Vertices[1],2.0));
+    EXPECT_TRUE(PathRouter.AddEdge(Vertices[1],Vertices[3],1.0));
+    EXPECT_TRUE(PathRouter.AddEdge(Vertices[3],Vertices[4],3.0,true));
+    std::vector< CPathRouter::TVertexID > Path, ExpectedPath = {0,2,1,3,4};
+    EXPECT_EQ(PathRouter.FindShortestPath(Vertices[0],Vertices[4],Path),7.0);
+    EXPECT_EQ(Path,ExpectedPath);
+    ExpectedPath = {4,3};
+    EXPECT_EQ(PathRouter.FindShortestPath(Vertices[4],Vertices[3],Path),3.0);
+    EXPECT_EQ(Path,ExpectedPath);
+    EXPECT_EQ(PathRouter.FindShortestPath(Vertices[4],Vertices[0],Path),CPathRouter::NoPathExists);
+    EXPECT_TRUE(Path.empty());
+}
+
+TEST(DijkstraPathRouter, ModifyAfterQueryTest){
+    CDijkstraPathRouter PathRouter;
+    auto Vertex0 = PathRouter.AddVertex(0);
+    auto Vertex1 = PathRouter.AddVertex(1);
+    std::vector< CPathRouter::TVertexID > Path;
+    EXPECT_EQ(PathRouter.FindShortestPath(Vertex0,Vertex1,Path),CPathRouter::NoPathExists);
+    // Edges and vertices added after a query must be visible to the next one
+    auto Vertex2 = PathRouter.AddVertex(2);
+    EXPECT_TRUE(PathRouter.AddEdge(Vertex0,Vertex2,1.0));
+    EXPECT_TRUE(PathRouter.AddEdge(Vertex2,Vertex1,1.5));
+    std::vector< CPathRouter::TVertexID > ExpectedPath = {0,2,1};
+    EXPECT_EQ(PathRouter.FindShortestPath(Vertex0,Vertex1,Path),2.5);
+    EXPECT_EQ(Path,ExpectedPath);
+    EXPECT_TRUE(PathRouter.Precompute(std::chrono::steady_clock::now()));
+    EXPECT_TRUE(PathRouter.AddEdge(Vertex0,Vertex1,2.0));
+    ExpectedPath = {0,1};
+    EXPECT_EQ(PathRouter.FindShortestPath(Vertex0,Vertex1,Path),2.0);
+    EXPECT_EQ(Path,ExpectedPath);
+}
+
+TEST(DijkstraPathRouter, RepeatedQueryTest){
+    // A grid where every query reuses the same search workspace
+    const std::size_t Width = 8;
+    CDijkstraPathRouter PathRouter;
+    for(std::size_t Index = 0; Index < Width * Width; Index++){
+        PathRouter.AddVertex(Index);
+    }
+    for(std::size_t Row = 0; Row < Width; Row++){
+        for(std::size_t Col = 0; Col < Width; Col++){
+            auto Vertex = Row * Width + Col;
+            if(Col + 1 < Width){
+                PathRouter.AddEdge(Vertex,Vertex + 1,1.0 + Row,true);
+            }
+            if(Row + 1 < Width){
+                PathRouter.AddEdge(Vertex,Vertex + Width,1.0,true);
+            }
+        }
+    }
+    std::vector< CPathRouter::TVertexID > Path;
+    for(int Repeat = 0; Repeat < 3; Repeat++){
+        // Cheapest is to cross along the top row
+        EXPECT_EQ(PathRouter.FindShortestPath(0,Width - 1,Path),Width - 1.0);
+        EXPECT_EQ(Path.size(),Width);
+        // Going down first and crossing the top row costs the same as the direct column
+        EXPECT_EQ(PathRouter.FindShortestPath(Width * Width - 1,0,Path),(Width - 1.0) * 2);
+        EXPECT_EQ(PathRouter.FindShortestPath(5,5,Path),0.0);
+        EXPECT_EQ(Path,std::vector< CPathRouter::TVertexID >{5});
+    }
+}
+
+TEST(DijkstraPathRouter, HeuristicTest){
+    // Grid with unit spacing, the Manhattan distance is an admissible bound on the remaining cost
+    const std::size_t Width = 10;
+    CDijkstraPathRouter PathRouter, AStarRouter;
+    for(std::size_t Index = 0; Index < Width * Width; Index++){
+        PathRouter.AddVertex(Index);
+        AStarRouter.AddVertex(Index);
+    }
+    for(std::size_t Row = 0; Row < Width; Row++){
+        for(std::size_t Col = 0; Col < Width; Col++){
+            auto Vertex = Row * Width + Col;
+            // Every third column is slow to force detours
+            double Weight = Col % 3 ? 1.0 : 2.5;
+            if(Col + 1 < Width){
+                PathRouter.AddEdge(Vertex,Vertex + 1,1.0,true);
+                AStarRouter.AddEdge(Vertex,Vertex + 1,1.0,true);
+            }
+            if(Row + 1 < Width){
+                PathRouter.AddEdge(Vertex,Vertex + Width,Weight,true);
+                AStarRouter.AddEdge(Vertex,Vertex + Width,Weight,true);
+            }
+        }
+    }
+    AStarRouter.SetHeuristic([Width](CPathRouter::TVertexID vertex, CPathRouter::TVertexID dest){
+        double RowDelta = double(vertex / Width) - double(dest / Width);
+        double ColDelta = double(vertex % Width) - double(dest % Width);
+        return std::abs(RowDelta) + std::abs(ColDelta);
+    });
+    std::vector< CPathRouter::TVertexID > Path, AStarPath;
+    for(CPathRouter::TVertexID Source = 0; Source < Width * Width; Source += 7){
+        for(CPathRouter::TVertexID Dest = 0; Dest < Width * Width; Dest += 11){
+            EXPECT_EQ(AStarRouter.FindShortestPath(Source,Dest,AStarPath),PathRouter.FindShortestPath(Source,Dest,Path));
+            EXPECT_EQ(AStarPath.front(),Source);
+            EXPECT_EQ(AStarPath.back(),Dest);
+        }
+    }
+    // Clearing the heuristic goes back to plain Dijkstra
+    AStarRouter.SetHeuristic(nullptr);
+    EXPECT_EQ(AStarRouter.FindShortestPath(0,Width * Width - 1,AStarPath),PathRouter.FindShortestPath(0,Width * Width - 1,Path));
+}
+
+TEST(DijkstraPathRouter, BidirectionalTest){
+    // Directed ring with chords, so the reverse adjacency differs from the forward one
+    const std::size_t Count = 30;
+    CDijkstraPathRouter PathRouter, BidirRouter;
+    BidirRouter.SetBidirectional(true);
+    for(std::size_t Index = 0; Index < Count; Index++){
+        PathRouter.AddVertex(Index);
+        BidirRouter.AddVertex(Index);
+    }
+    for(std::size_t Index = 0; Index < Count; Index++){
+        double Weight = 1.0 + (Index % 4) * 0.25;
+        PathRouter.AddEdge(Index,(Index + 1) % Count,Weight);
+        BidirRouter.AddEdge(Index,(Index + 1) % Count,Weight);
+        if(Index % 5 == 0){
+            PathRouter.AddEdge(Index,(Index + 7) % Count,4.5);
+            BidirRouter.AddEdge(Index,(Index + 7) % Count,4.5);
+        }
+    }
+    auto Isolated = PathRouter.AddVertex(Count);
+    BidirRouter.AddVertex(Count);
+    std::vector< CPathRouter::TVertexID > Path, BidirPath;
+    for(CPathRouter::TVertexID Source = 0; Source < Count; Source += 3){
+        for(CPathRouter::TVertexID Dest = 0; Dest < Count; Dest += 4){
+            EXPECT_EQ(BidirRouter.FindShortestPath(Source,Dest,BidirPath),PathRouter.FindShortestPath(Source,Dest,Path));
+            ASSERT_FALSE(BidirPath.empty());
+            EXPECT_EQ(BidirPath.front(),Source);
+            EXPECT_EQ(BidirPath.back(),Dest);
+            EXPECT_EQ(BidirPath.size(),Path.size());
+        }
+    }
+    EXPECT_EQ(BidirRouter.FindShortestPath(0,Isolated,BidirPath),CPathRouter::NoPathExists);
+    EXPECT_TRUE(BidirPath.empty());
+    EXPECT_EQ(BidirRouter.FindShortestPath(Isolated,Isolated,BidirPath),0.0);
+    EXPECT_EQ(BidirPath,std::vector< CPathRouter::TVertexID >{Isolated});
+}
+
+TEST(DijkstraPathRouter, LandmarkTest){
+    // Directed ring with chords plus a second component, so landmarks have to cover both
+    const std::size_t Count = 40;
+    CDijkstraPathRouter PathRouter, LandmarkRouter;
+    LandmarkRouter.SetLandmarkCount(4);
+    for(std::size_t Index = 0; Index < Count + 3; Index++){
+        PathRouter.AddVertex(Index);
+        LandmarkRouter.AddVertex(Index);
+    }
+    for(std::size_t Index = 0; Index < Count; Index++){
+        double Weight = 1.0 + (Index % 3) * 0.5;
+        PathRouter.AddEdge(Index,(Index + 1) % Count,Weight);
+        LandmarkRouter.AddEdge(Index,(Index + 1) % Count,Weight);
+        if(Index % 6 == 0){
+            PathRouter.AddEdge(Index,(Index + 11) % Count,5.0,true);
+            LandmarkRouter.AddEdge(Index,(Index + 11) % Count,5.0,true);
+        }
+    }
+    PathRouter.AddEdge(Count,Count + 1,2.0,true);
+    LandmarkRouter.AddEdge(Count,Count + 1,2.0,true);
+    EXPECT_TRUE(LandmarkRouter.Landmarks().empty());
+    EXPECT_TRUE(LandmarkRouter.Precompute(std::chrono::steady_clock::now() + std::chrono::seconds(10)));
+    auto Landmarks = LandmarkRouter.Landmarks();
+    EXPECT_EQ(Landmarks.size(),4);
+    EXPECT_TRUE(std::any_of(Landmarks.begin(),Landmarks.end(),[Count](CPathRouter::TVertexID vertex){ return vertex >= Count; }));
+
+    std::vector< CPathRouter::TVertexID > Path, LandmarkPath;
+    for(CPathRouter::TVertexID Source = 0; Source < Count + 3; Source += 3){
+        for(CPathRouter::TVertexID Dest = 0; Dest < Count + 3; Dest += 2){
+            EXPECT_EQ(LandmarkRouter.FindShortestPath(Source,Dest,LandmarkPath),PathRouter.FindShortestPath(Source,Dest,Path));
+            EXPECT_EQ(LandmarkPath.size(),Path.size());
+        }
+    }
+    // Changing the graph drops the tables rather than using stale bounds
+    PathRouter.AddEdge(5,30,0.5);
+    LandmarkRouter.AddEdge(5,30,0.5);
+    EXPECT_TRUE(LandmarkRouter.Landmarks().empty());
+    EXPECT_EQ(LandmarkRouter.FindShortestPath(5,30,LandmarkPath),0.5);
+    // A deadline that already passed leaves queries on plain Dijkstra
+    EXPECT_FALSE(LandmarkRouter.Precompute(std::chrono::steady_clock::now()));
+    EXPECT_EQ(LandmarkRouter.FindShortestPath(0,30,LandmarkPath),PathRouter.FindShortestPath(0,30,Path));
+}
+
+TEST(DijkstraPathRouter, PrecomputeTest){
+    CDijkstraPathRouter PathRouter;
+    for(int Index = 0; Index < 50; Index++){
+        PathRouter.AddVertex(Index);
+    }
+    for(int Index = 1; Index < 50; Index++){
+        PathRouter.AddEdge(Index - 1,Index,1.0,true);
+    }
+    EXPECT_EQ(PathRouter.PrecomputeProgress(),0.0);
+    // Precompute returns once its work is done instead of waiting out the deadline
+    auto Start = std::chrono::steady_clock::now();
+    EXPECT_TRUE(PathRouter.Precompute(Start + std::chrono::seconds(30)));
+    EXPECT_LT(std::chrono::steady_clock::now() - Start,std::chrono::seconds(5));
+    EXPECT_EQ(PathRouter.PrecomputeProgress(),1.0);
+
+    // Landmarks are picked one per unit of work, an interrupted run is resumed by the next call
+    PathRouter.SetLandmarkCount(3);
+    EXPECT_LT(PathRouter.PrecomputeProgress(),1.0);
+    EXPECT_FALSE(PathRouter.Precompute(std::chrono::steady_clock::now()));
+    EXPECT_TRUE(PathRouter.Landmarks().empty());
+    Start = std::chrono::steady_clock::now();
+    EXPECT_TRUE(PathRouter.Precompute(Start + std::chrono::seconds(30)));
+    EXPECT_LT(std::chrono::steady_clock::now() - Start,std::chrono::seconds(5));
+    EXPECT_EQ(PathRouter.Landmarks().size(),3);
+    EXPECT_EQ(PathRouter.PrecomputeProgress(),1.0);
+    std::vector< CPathRouter::TVertexID > Path;
+    EXPECT_EQ(PathRouter.FindShortestPath(10,40,Path),30.0);
+}
+
+TEST(DijkstraPathRouter, DistancesTest){
+    CDijkstraPathRouter PathRouter;
+    for(int Index = 0; Index < 5; Index++){
+        PathRouter.AddVertex(Index);
+    }
+    PathRouter.AddEdge(0,1,4.0);
+    PathRouter.AddEdge(0,2,1.0);
+    PathRouter.AddEdge(2,1,2.0);
+    PathRouter.AddEdge(1,3,1.0);
+    PathRouter.AddEdge(3,4,3.0,true);
+    std::vector< std::vector<double> > Distances;
+    // Repeated and out of range vertices get their own rows and columns
+    PathRouter.FindDistances({0,4,7,0},{1,4,0,4,9},Distances);
+    std::vector< std::vector<double> > ExpectedDistances = {{3.0,7.0,0.0,7.0,CPathRouter::NoPathExists},
+                                                           {CPathRouter::NoPathExists,0.0,CPathRouter::NoPathExists,0.0,CPathRouter::NoPathExists},
+                                                           {CPathRouter::NoPathExists,CPathRouter::NoPathExists,CPathRouter::NoPathExists,CPathRouter::NoPathExists,CPathRouter::NoPathExists},
+                                                           {3.0,7.0,0.0,7.0,CPathRouter::NoPathExists}};
+    EXPECT_EQ(Distances,ExpectedDistances);
+    PathRouter.FindDistances({0},{},Distances);
+    ASSERT_EQ(Distances.size(),1);
+    EXPECT_TRUE(Distances[0].empty());
+}
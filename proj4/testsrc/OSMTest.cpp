@@ -28,15 +28,17 @@ TEST(OSMTest, SimpleNodeTest){
     EXPECT_EQ(StreetMap.WayCount(),0);
     auto TempNode1 = StreetMap.NodeByIndex(0);
     auto TempNode2 = StreetMap.NodeByID(1);
-    EXPECT_EQ(TempNode1,TempNode2);
     ASSERT_TRUE(bool(TempNode1));
+    ASSERT_TRUE(bool(TempNode2));
+    EXPECT_EQ(TempNode1->ID(),TempNode2->ID());
     EXPECT_EQ(TempNode1->ID(),1);
     EXPECT_EQ(TempNode1->AttributeCount(),0);
     EXPECT_EQ(TempNode1->Location(),std::make_pair(38.5,-121.7));
     TempNode1 = StreetMap.NodeByIndex(1);
     TempNode2 = StreetMap.NodeByID(2);
-    EXPECT_EQ(TempNode1,TempNode2);
     ASSERT_TRUE(bool(TempNode1));
+    ASSERT_TRUE(bool(TempNode2));
+    EXPECT_EQ(TempNode1->ID(),TempNode2->ID());
     EXPECT_EQ(TempNode1->ID(),2);
     EXPECT_EQ(TempNode1->AttributeCount(),0);
     EXPECT_EQ(TempNode1->Location(),std::make_pair(38.5,-121.71));
@@ -58,8 +60,9 @@ TEST(OSMTest, NodeTest){
     EXPECT_EQ(StreetMap.WayCount(),0);
     auto TempNode1 = StreetMap.NodeByIndex(0);
     auto TempNode2 = StreetMap.NodeByID(1);
-    EXPECT_EQ(TempNode1,TempNode2);
     ASSERT_TRUE(bool(TempNode1));
+    ASSERT_TRUE(bool(TempNode2));
+    EXPECT_EQ(TempNode1->ID(),TempNode2->ID());
     EXPECT_EQ(TempNode1->ID(),1);
     EXPECT_EQ(TempNode1->AttributeCount(),2);
     EXPECT_EQ(TempNode1->Location(),std::make_pair(38.5,-121.7));
@@ -69,8 +72,9 @@ TEST(OSMTest, NodeTest){
     EXPECT_EQ(TempNode1->GetAttribute("bicycle"),"yes");
     TempNode1 = StreetMap.NodeByIndex(1);
     TempNode2 = StreetMap.NodeByID(2);
-    EXPECT_EQ(TempNode1,TempNode2);
     ASSERT_TRUE(bool(TempNode1));
+    ASSERT_TRUE(bool(TempNode2));
+    EXPECT_EQ(TempNode1->ID(),TempNode2->ID());
     EXPECT_EQ(TempNode1->ID(),2);
     EXPECT_EQ(TempNode1->AttributeCount(),0);
     EXPECT_EQ(TempNode1->Location(),std::make_pair(38.5,-121.71));
@@ -4,6 +4,8 @@
 #include <gtest/gtest.h>
 #include <memory>
 #include <sstream>
+#include <stdexcept>
+#include <vector>
 
 // Test fixture for COpenStreetMap
 class COpenStreetMapTest : public ::testing::Test {
@@ -89,6 +91,146 @@ TEST_F(COpenStreetMapTest, WayByID) {
     EXPECT_EQ(way->GetAttribute("name"), "Way1");
 }
 
+// Test lookups of IDs that are not in the map
+TEST_F(COpenStreetMapTest, MissingID) {
+    EXPECT_EQ(OpenStreetMap->NodeByID(3), nullptr);
+    EXPECT_EQ(OpenStreetMap->WayByID(2), nullptr);
+    EXPECT_EQ(OpenStreetMap->NodeByIndex(2), nullptr);
+    EXPECT_EQ(OpenStreetMap->WayByIndex(1), nullptr);
+}
+
+// Test that ID lookups find the same node as index lookups in a larger map with unsorted IDs
+TEST(COpenStreetMapLookupTest, ManyNodes) {
+    std::ostringstream xmlData;
+    xmlData << "<osm>";
+    for (int Index = 0; Index < 1000; Index++) {
+        xmlData << "<node id=\"" << (Index * 7919) % 1000 + 5000 << "\" lat=\"" << Index << "\" lon=\"0\"/>";
+    }
+    xmlData << "<way id=\"9\"><nd ref=\"5000\"/></way><way id=\"4\"><nd ref=\"5001\"/></way>";
+    xmlData << "</osm>";
+    COpenStreetMap StreetMap(std::make_shared<CXMLReader>(std::make_shared<CStringDataSource>(xmlData.str())));
+    ASSERT_EQ(StreetMap.NodeCount(), 1000);
+    for (std::size_t Index = 0; Index < StreetMap.NodeCount(); Index++) {
+        auto Node = StreetMap.NodeByIndex(Index);
+        auto NodeByID = StreetMap.NodeByID(Node->ID());
+        ASSERT_NE(NodeByID, nullptr);
+        EXPECT_EQ(NodeByID->ID(), Node->ID());
+        EXPECT_EQ(NodeByID->Location(), Node->Location());
+    }
+    EXPECT_EQ(StreetMap.NodeByID(4999), nullptr);
+    EXPECT_EQ(StreetMap.WayByID(4), StreetMap.WayByIndex(1));
+    EXPECT_EQ(StreetMap.WayByID(9), StreetMap.WayByIndex(0));
+}
+
+// Test that nodes stay usable after the map that created them is gone
+TEST(COpenStreetMapLookupTest, NodeOutlivesMap) {
+    std::shared_ptr<CStreetMap::SNode> Node;
+    {
+        COpenStreetMap StreetMap(std::make_shared<CXMLReader>(std::make_shared<CStringDataSource>("<osm><node id=\"7\" lat=\"1.5\" lon=\"2.5\"><tag k=\"name\" v=\"Seven\"/></node></osm>")));
+        Node = StreetMap.NodeByID(7);
+    }
+    ASSERT_NE(Node, nullptr);
+    EXPECT_EQ(Node->ID(), 7);
+    EXPECT_EQ(Node->Location(), std::make_pair(1.5, 2.5));
+    EXPECT_EQ(Node->AttributeCount(), 1);
+    EXPECT_EQ(Node->GetAttributeKey(0), "name");
+    EXPECT_EQ(Node->GetAttribute("name"), "Seven");
+    EXPECT_FALSE(Node->HasAttribute("highway"));
+}
+
+// Test that keys and values shared by nodes and ways are each looked up correctly
+TEST(COpenStreetMapLookupTest, SharedAttributes) {
+    std::string xmlData = R"(
+        <osm>
+            <node id="1" lat="0" lon="0"><tag k="highway" v="stop"/></node>
+            <node id="2" lat="0" lon="1"/>
+            <way id="5"><nd ref="1"/><nd ref="2"/><tag k="highway" v="residential"/><tag k="name" v="highway"/></way>
+            <way id="6"><nd ref="2"/><nd ref="1"/><tag k="name" v="A St."/><tag k="highway" v="residential"/></way>
+        </osm>
+    )";
+    COpenStreetMap StreetMap(std::make_shared<CXMLReader>(std::make_shared<CStringDataSource>(xmlData)));
+    auto Node = StreetMap.NodeByID(1);
+    ASSERT_NE(Node, nullptr);
+    EXPECT_EQ(Node->GetAttribute("highway"), "stop");
+    EXPECT_FALSE(StreetMap.NodeByID(2)->HasAttribute("highway"));
+    auto Way = StreetMap.WayByID(5);
+    ASSERT_NE(Way, nullptr);
+    EXPECT_EQ(Way->AttributeCount(), 2);
+    EXPECT_EQ(Way->GetAttributeKey(0), "highway");
+    EXPECT_EQ(Way->GetAttributeKey(1), "name");
+    EXPECT_EQ(Way->GetAttributeKey(2), "");
+    EXPECT_EQ(Way->GetAttribute("name"), "highway");
+    // Strings that only ever appear as values are not keys
+    EXPECT_FALSE(Way->HasAttribute("residential"));
+    EXPECT_EQ(Way->GetAttribute("residential"), "");
+    EXPECT_FALSE(Way->HasAttribute("oneway"));
+    Way = StreetMap.WayByID(6);
+    ASSERT_NE(Way, nullptr);
+    EXPECT_EQ(Way->GetAttributeKey(0), "name");
+    EXPECT_EQ(Way->GetAttribute("name"), "A St.");
+    EXPECT_EQ(Way->GetAttribute("highway"), "residential");
+}
+
+// Test that loading straight from the source builds the same map as loading through CXMLReader
+TEST(COpenStreetMapLookupTest, DirectLoad) {
+    std::string xmlData = R"(<?xml version='1.0' encoding='UTF-8'?>
+        <osm version="0.6">
+            <node id="3" lat="38.5" lon="-121.75" version="2"><tag k="highway" v="stop"/></node>
+            <node id="1" lat="-0.25" lon="1e-3"/>
+            <way id="7">
+                <nd ref="3"/><nd ref="1"/>
+                <tag k="name" v="A &amp; B St."/>
+                <tag k="highway" v="residential"/>
+            </way>
+        </osm>
+    )";
+    COpenStreetMap ReaderMap(std::make_shared<CXMLReader>(std::make_shared<CStringDataSource>(xmlData)));
+    COpenStreetMap DirectMap(std::make_shared<CStringDataSource>(xmlData));
+    for (auto StreetMap : {&ReaderMap, &DirectMap}) {
+        ASSERT_EQ(StreetMap->NodeCount(), 2);
+        ASSERT_EQ(StreetMap->WayCount(), 1);
+        auto Node = StreetMap->NodeByID(3);
+        ASSERT_NE(Node, nullptr);
+        EXPECT_EQ(Node->Location(), std::make_pair(38.5, -121.75));
+        EXPECT_EQ(Node->AttributeCount(), 2);
+        EXPECT_EQ(Node->GetAttribute("version"), "2");
+        EXPECT_EQ(Node->GetAttribute("highway"), "stop");
+        Node = StreetMap->NodeByID(1);
+        ASSERT_NE(Node, nullptr);
+        EXPECT_EQ(Node->Location(), std::make_pair(-0.25, 0.001));
+        EXPECT_EQ(Node->AttributeCount(), 0);
+        auto Way = StreetMap->WayByID(7);
+        ASSERT_NE(Way, nullptr);
+        EXPECT_EQ(Way->NodeCount(), 2);
+        EXPECT_EQ(Way->GetNodeID(0), 3);
+        EXPECT_EQ(Way->GetNodeID(1), 1);
+        EXPECT_EQ(Way->GetAttributeKey(0), "name");
+        EXPECT_EQ(Way->GetAttribute("name"), "A & B St.");
+        EXPECT_EQ(Way->GetAttribute("highway"), "residential");
+    }
+}
+
+// Test that loading straight from the source rejects broken documents instead of keeping part of them
+TEST(COpenStreetMapLookupTest, DirectLoadErrors) {
+    std::vector<std::string> BadDocuments = {
+        // Truncated inside a way
+        R"(<osm><node id="1" lat="1.0" lon="2.0"/><way id="7"><nd ref="1"/>)",
+        // Mismatched end tag
+        R"(<osm><node id="1" lat="1.0" lon="2.0"></way></osm>)",
+        // Numbers that are not numbers, missing or followed by junk
+        R"(<osm><node id="x" lat="1.0" lon="2.0"/></osm>)",
+        R"(<osm><node id="1" lat="1.0"/></osm>)",
+        R"(<osm><node id="1" lat="1.0q" lon="2.0"/></osm>)",
+        R"(<osm><way id="-7"><nd ref="1"/></way></osm>)",
+        R"(<osm><way id="7"><nd ref="one"/></way></osm>)"
+    };
+    for (const auto &Document : BadDocuments) {
+        EXPECT_THROW(COpenStreetMap(std::make_shared<CStringDataSource>(Document)), std::runtime_error) << Document;
+    }
+    COpenStreetMap StreetMap(std::make_shared<CStringDataSource>(R"(<osm><node id="1" lat="1.0" lon="2.0"/></osm>)"));
+    EXPECT_EQ(StreetMap.NodeCount(), 1);
+}
+
 int main(int argc, char **argv) {
     ::testing::InitGoogleTest(&argc, argv);
     return RUN_ALL_TESTS();
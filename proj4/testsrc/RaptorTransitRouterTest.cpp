@@ -0,0 +1,129 @@
+#include <gtest/gtest.h>
+#include "RaptorTransitRouter.h"
+#include "StringDataSource.h"
+#include "DSVReader.h"
+
+static std::shared_ptr<CRaptorTransitRouter> CreateRouter(const std::string &stoptimes){
+    return std::make_shared<CRaptorTransitRouter>(std::make_shared<CDSVReader>(std::make_shared<CStringDataSource>(stoptimes),','));
+}
+
+TEST(RaptorTransitRouter, ParseTimeTest){
+    CRaptorTransitRouter::TTime Time;
+    EXPECT_TRUE(CRaptorTransitRouter::ParseTime("8:05",Time));
+    EXPECT_EQ(Time,8*3600 + 5*60);
+    EXPECT_TRUE(CRaptorTransitRouter::ParseTime("08:05:30",Time));
+    EXPECT_EQ(Time,8*3600 + 5*60 + 30);
+    EXPECT_TRUE(CRaptorTransitRouter::ParseTime("25:00:00",Time));
+    EXPECT_EQ(Time,25*3600);
+    EXPECT_FALSE(CRaptorTransitRouter::ParseTime("time",Time));
+    EXPECT_FALSE(CRaptorTransitRouter::ParseTime("8",Time));
+    EXPECT_FALSE(CRaptorTransitRouter::ParseTime("8:60",Time));
+    EXPECT_FALSE(CRaptorTransitRouter::ParseTime("8:5",Time));
+    EXPECT_FALSE(CRaptorTransitRouter::ParseTime("8:05:00:00",Time));
+}
+
+TEST(RaptorTransitRouter, LoadTest){
+    auto Router = CreateRouter( "route,trip,stop_id,time\n"
+                                "C,C1,1,7:00\n"
+                                "A,A1,1,8:00\n"
+                                "A,A1,2,8:10\n"
+                                "A,A2,1,8:05\n"
+                                "A,A2,2,8:08\n"
+                                "A,A3,1,9:00\n"
+                                "A,A3,2,9:10\n"
+                                "B,B1,2,9:00\n"
+                                "B,B1,3,8:50\n"
+                                "B,B2,3,9:00\n"
+                                "C,C1,3,7:30\n");
+    // A2 overtakes A1 so it needs a pattern of its own, B1 goes back in time and B2 goes nowhere
+    EXPECT_EQ(Router->TripCount(),4);
+    EXPECT_EQ(Router->PatternCount(),3);
+    EXPECT_EQ(Router->StopCount(),3);
+    std::vector< CRaptorTransitRouter::TStopID > ExpectedStops = {1,2,3};
+    EXPECT_EQ(Router->Stops(),ExpectedStops);
+    EXPECT_TRUE(Router->AddTransfer(1,3,60));
+    EXPECT_FALSE(Router->AddTransfer(1,4,60));
+}
+
+TEST(RaptorTransitRouter, HopFilterTest){
+    auto StopTimes = std::make_shared<CStringDataSource>(   "route,trip,stop_id,time\n"
+                                                            "A,A1,1,8:00\n"
+                                                            "A,A1,2,8:10\n"
+                                                            "A,A1,3,8:20\n"
+                                                            "B,B1,2,8:00\n"
+                                                            "B,B1,3,8:10\n");
+    // Route A does not run from stop 2 to stop 3, so all of A1 is dropped
+    CRaptorTransitRouter Router(std::make_shared<CDSVReader>(StopTimes,','),[](const std::string &route, CRaptorTransitRouter::TStopID src, CRaptorTransitRouter::TStopID dest){
+        return route != "A" || src != 2;
+    });
+    EXPECT_EQ(Router.TripCount(),1);
+    std::vector< CRaptorTransitRouter::TStopID > ExpectedStops = {2,3};
+    EXPECT_EQ(Router.Stops(),ExpectedStops);
+}
+
+TEST(RaptorTransitRouter, SingleRouteTest){
+    auto Router = CreateRouter( "route,trip,stop_id,time\n"
+                                "A,A1,1,8:00\n"
+                                "A,A1,2,8:10\n"
+                                "A,A1,3,8:20\n"
+                                "A,A2,1,8:30\n"
+                                "A,A2,2,8:40\n"
+                                "A,A2,3,8:50\n");
+    std::vector< CRaptorTransitRouter::SLeg > Journey;
+    // Leaving at 8:10 with a 5 minute walk to stop 1 misses A1 and waits for A2
+    EXPECT_EQ(Router->FindEarliestArrival({{1,300}},{{3,120}},8*3600 + 600,Journey),8*3600 + 50*60 + 120);
+    ASSERT_EQ(Journey.size(),1);
+    EXPECT_FALSE(Journey[0].DWalk);
+    EXPECT_EQ(Journey[0].DRoute,"A");
+    EXPECT_EQ(Journey[0].DTrip,"A2");
+    std::vector< CRaptorTransitRouter::TStopID > ExpectedStops = {1,2,3};
+    EXPECT_EQ(Journey[0].DStops,ExpectedStops);
+    EXPECT_EQ(Journey[0].DDeparture,8*3600 + 30*60);
+    EXPECT_EQ(Journey[0].DArrival,8*3600 + 50*60);
+    // Catching A1 exactly on time
+    EXPECT_EQ(Router->FindEarliestArrival({{2,0}},{{3,0}},8*3600 + 600,Journey),8*3600 + 20*60);
+    ASSERT_EQ(Journey.size(),1);
+    EXPECT_EQ(Journey[0].DTrip,"A1");
+    // Nothing runs backwards or after the last trip
+    EXPECT_EQ(Router->FindEarliestArrival({{3,0}},{{1,0}},8*3600,Journey),CRaptorTransitRouter::NoArrival);
+    EXPECT_TRUE(Journey.empty());
+    EXPECT_EQ(Router->FindEarliestArrival({{1,0}},{{3,0}},9*3600,Journey),CRaptorTransitRouter::NoArrival);
+    EXPECT_EQ(Router->FindEarliestArrival({{4,0}},{{3,0}},8*3600,Journey),CRaptorTransitRouter::NoArrival);
+}
+
+TEST(RaptorTransitRouter, TransferTest){
+    auto Router = CreateRouter( "route,trip,stop_id,time\n"
+                                "A,A1,1,8:00\n"
+                                "A,A1,2,8:10\n"
+                                "B,B1,3,8:12\n"
+                                "B,B1,4,8:30\n"
+                                "B,B2,3,8:20\n"
+                                "B,B2,4,8:38\n"
+                                "C,C1,1,8:00\n"
+                                "C,C1,5,8:20\n"
+                                "C,C1,4,9:00\n");
+    // The walk from 2 to 3 is too long for B1
+    ASSERT_TRUE(Router->AddTransfer(2,3,180));
+    std::vector< CRaptorTransitRouter::SLeg > Journey;
+    EXPECT_EQ(Router->FindEarliestArrival({{1,0}},{{4,0}},7*3600,Journey),8*3600 + 38*60);
+    ASSERT_EQ(Journey.size(),3);
+    EXPECT_EQ(Journey[0].DTrip,"A1");
+    EXPECT_TRUE(Journey[1].DWalk);
+    std::vector< CRaptorTransitRouter::TStopID > ExpectedWalk = {2,3};
+    EXPECT_EQ(Journey[1].DStops,ExpectedWalk);
+    EXPECT_EQ(Journey[1].DDeparture,8*3600 + 10*60);
+    EXPECT_EQ(Journey[1].DArrival,8*3600 + 13*60);
+    EXPECT_EQ(Journey[2].DRoute,"B");
+    EXPECT_EQ(Journey[2].DTrip,"B2");
+    // With a single ride only the slow direct route is left
+    EXPECT_EQ(Router->FindEarliestArrival({{1,0}},{{4,0}},7*3600,Journey,1),9*3600);
+    ASSERT_EQ(Journey.size(),1);
+    EXPECT_EQ(Journey[0].DTrip,"C1");
+    std::vector< CRaptorTransitRouter::TStopID > ExpectedStops = {1,5,4};
+    EXPECT_EQ(Journey[0].DStops,ExpectedStops);
+    // Walking from stop 5 to the destination beats riding on
+    EXPECT_EQ(Router->FindEarliestArrival({{1,0}},{{4,0},{5,600}},7*3600,Journey),8*3600 + 30*60);
+    ASSERT_EQ(Journey.size(),1);
+    EXPECT_EQ(Journey[0].DTrip,"C1");
+    EXPECT_EQ(Journey[0].DStops.back(),5);
+}
@@ -0,0 +1,96 @@
+#include <gtest/gtest.h>
+#include "StreetMapNodeIndex.h"
+#include "OpenStreetMap.h"
+#include "XMLReader.h"
+#include "StringDataSource.h"
+#include "GeographicUtils.h"
+#include <algorithm>
+#include <random>
+#include <sstream>
+#include <iomanip>
+
+static std::shared_ptr<CStreetMap> CreateStreetMap(const std::string &body){
+    auto InStreamOSM = std::make_shared<CStringDataSource>( "<?xml version='1.0' encoding='UTF-8'?>"
+                                                            "<osm version=\"0.6\" generator=\"osmconvert 0.8.5\">" + body + "</osm>");
+    return std::make_shared<COpenStreetMap>(std::make_shared<CXMLReader>(InStreamOSM));
+}
+
+TEST(StreetMapNodeIndex, EmptyTest){
+    CStreetMapNodeIndex Index(CreateStreetMap(""));
+    EXPECT_EQ(Index.NodeCount(),0);
+    EXPECT_TRUE(Index.NearestNode(std::make_pair(38.5,-121.7)) == CStreetMap::InvalidNodeID);
+    EXPECT_TRUE(Index.NearestNodes(std::make_pair(38.5,-121.7),3).empty());
+}
+
+TEST(StreetMapNodeIndex, RoutableTest){
+    auto StreetMap = CreateStreetMap(   "<node id=\"1\" lat=\"38.5\" lon=\"-121.7\"/>"
+                                        "<node id=\"2\" lat=\"38.6\" lon=\"-121.7\"/>"
+                                        "<node id=\"3\" lat=\"38.55\" lon=\"-121.7\"/>"
+                                        "<way id=\"10\">"
+                                        "<nd ref=\"1\"/>"
+                                        "<nd ref=\"2\"/>"
+                                        "</way>");
+    CStreetMapNodeIndex Index(StreetMap);
+    EXPECT_EQ(Index.NodeCount(),2);
+    EXPECT_TRUE(Index.Contains(1));
+    EXPECT_FALSE(Index.Contains(3));
+    EXPECT_FALSE(Index.Contains(4));
+    EXPECT_EQ(Index.NearestNode(std::make_pair(38.56,-121.7)),2);
+    EXPECT_EQ(Index.NearestNode(std::make_pair(38.54,-121.7)),1);
+    // Locations outside the map still find the nodes on its edge
+    EXPECT_EQ(Index.NearestNode(std::make_pair(40.0,-100.0)),2);
+    EXPECT_EQ(Index.NearestNode(std::make_pair(30.0,-130.0)),1);
+    std::vector< CStreetMap::TNodeID > ExpectedNodes = {2,1};
+    EXPECT_EQ(Index.NearestNodes(std::make_pair(38.56,-121.7),5),ExpectedNodes);
+
+    CStreetMapNodeIndex AllIndex(StreetMap,false);
+    EXPECT_EQ(AllIndex.NodeCount(),3);
+    EXPECT_TRUE(AllIndex.Contains(3));
+    EXPECT_EQ(AllIndex.NearestNode(std::make_pair(38.56,-121.7)),3);
+    ExpectedNodes = {3,2};
+    EXPECT_EQ(AllIndex.NearestNodes(std::make_pair(38.56,-121.7),2),ExpectedNodes);
+}
+
+TEST(StreetMapNodeIndex, NearlyCollinearTest){
+    // A long line that is off straight by a hair has almost no area, the cells must still span it
+    auto StreetMap = CreateStreetMap(   "<node id=\"1\" lat=\"38.5\" lon=\"-160.0\"/>"
+                                        "<node id=\"2\" lat=\"38.500000000001\" lon=\"-120.0\"/>"
+                                        "<node id=\"3\" lat=\"38.5\" lon=\"-80.0\"/>");
+    CStreetMapNodeIndex Index(StreetMap,false);
+    EXPECT_EQ(Index.NodeCount(),3);
+    EXPECT_EQ(Index.NearestNode(std::make_pair(38.5,-150.0)),1);
+    EXPECT_EQ(Index.NearestNode(std::make_pair(39.0,-115.0)),2);
+    std::vector< CStreetMap::TNodeID > ExpectedNodes = {3,2,1};
+    EXPECT_EQ(Index.NearestNodes(std::make_pair(38.0,-85.0),3),ExpectedNodes);
+}
+
+TEST(StreetMapNodeIndex, RandomTest){
+    // Clustered nodes leave most grid cells empty, compare against checking every node
+    std::mt19937 Generator(7);
+    std::uniform_real_distribution<double> Offset(0.0, 1.0);
+    std::ostringstream Body;
+    Body<<std::setprecision(12);
+    std::vector< std::pair<CStreetMap::TNodeID, CStreetMap::TLocation> > Nodes;
+    for(CStreetMap::TNodeID NodeID = 1; NodeID <= 500; NodeID++){
+        auto Scale = NodeID % 5 ? 0.01 : 0.2;
+        CStreetMap::TLocation Location = std::make_pair(38.5 + Offset(Generator) * Scale, -121.8 + Offset(Generator) * Scale);
+        Nodes.push_back(std::make_pair(NodeID,Location));
+        Body<<"<node id=\""<<NodeID<<"\" lat=\""<<Location.first<<"\" lon=\""<<Location.second<<"\"/>";
+    }
+    CStreetMapNodeIndex Index(CreateStreetMap(Body.str()),false);
+    ASSERT_EQ(Index.NodeCount(),Nodes.size());
+    for(int Query = 0; Query < 100; Query++){
+        CStreetMap::TLocation Location = std::make_pair(38.45 + Offset(Generator) * 0.3, -121.85 + Offset(Generator) * 0.3);
+        std::vector< std::pair<double, CStreetMap::TNodeID> > Distances;
+        for(auto &Node : Nodes){
+            Distances.push_back(std::make_pair(SGeographicUtils::HaversineDistanceInMiles(Location,Node.second),Node.first));
+        }
+        std::sort(Distances.begin(),Distances.end());
+        EXPECT_EQ(Index.NearestNode(Location),Distances[0].second);
+        auto Nearest = Index.NearestNodes(Location,4);
+        ASSERT_EQ(Nearest.size(),4);
+        for(std::size_t Rank = 0; Rank < Nearest.size(); Rank++){
+            EXPECT_EQ(Nearest[Rank],Distances[Rank].second);
+        }
+    }
+}
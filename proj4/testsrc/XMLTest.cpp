@@ -167,30 +167,113 @@ TEST(XMLReaderTest, LongCDataTest){
     EXPECT_TRUE(Reader.End());
 }
 
-// TEST(XMLReaderTest, SpecialCharacterTest){
-//     auto InStream = std::make_shared<CStringDataSource>( "<elem attr=\"&amp;&quot;&apos;&lt;&gt;\">&amp;&quot;&apos;&lt;&gt;</elem>");
-//     CXMLReader Reader(InStream);
-//     SXMLEntity Entity;
+TEST(XMLReaderTest, SpecialCharacterTest){
+    auto InStream = std::make_shared<CStringDataSource>( "<elem attr=\"&amp;&quot;&apos;&lt;&gt;\">&amp;&quot;&apos;&lt;&gt;</elem>");
+    CXMLReader Reader(InStream);
+    SXMLEntity Entity;
 
-//     EXPECT_TRUE(Reader.ReadEntity(Entity));
-//     EXPECT_EQ(Entity.DType, SXMLEntity::EType::StartElement);
-//     EXPECT_EQ(Entity.DNameData, "elem");
-//     EXPECT_EQ(Entity.DAttributes.size(), 1);
-//     EXPECT_TRUE(Entity.AttributeExists("attr"));
-//     EXPECT_EQ(Entity.AttributeValue("attr"), "&\"'<>");
-    
-//     EXPECT_TRUE(Reader.ReadEntity(Entity));
-//     EXPECT_EQ(Entity.DType, SXMLEntity::EType::CharData);
-//     EXPECT_EQ(Entity.DNameData, "&\"'<>");
-//     EXPECT_EQ(Entity.DAttributes.size(), 0);
-    
-//     EXPECT_TRUE(Reader.ReadEntity(Entity));
-//     EXPECT_EQ(Entity.DType, SXMLEntity::EType::EndElement);
-//     EXPECT_EQ(Entity.DNameData, "elem");
-//     EXPECT_EQ(Entity.DAttributes.size(), 0);
-    
-//     EXPECT_TRUE(Reader.End());
-// }
+    EXPECT_TRUE(Reader.ReadEntity(Entity));
+    EXPECT_EQ(Entity.DType, SXMLEntity::EType::StartElement);
+    EXPECT_EQ(Entity.DNameData, "elem");
+    EXPECT_EQ(Entity.DAttributes.size(), 1);
+    EXPECT_TRUE(Entity.AttributeExists("attr"));
+    EXPECT_EQ(Entity.AttributeValue("attr"), "&\"'<>");
+    
+    EXPECT_TRUE(Reader.ReadEntity(Entity));
+    EXPECT_EQ(Entity.DType, SXMLEntity::EType::CharData);
+    EXPECT_EQ(Entity.DNameData, "&\"'<>");
+    EXPECT_EQ(Entity.DAttributes.size(), 0);
+    
+    EXPECT_TRUE(Reader.ReadEntity(Entity));
+    EXPECT_EQ(Entity.DType, SXMLEntity::EType::EndElement);
+    EXPECT_EQ(Entity.DNameData, "elem");
+    EXPECT_EQ(Entity.DAttributes.size(), 0);
+    
+    EXPECT_TRUE(Reader.End());
+}
+
+TEST(XMLReaderTest, EscapedAttributeTest){
+    // Entities that were escaped twice in the document are decoded down to the character
+    auto InStream = std::make_shared<CStringDataSource>( "<elem plain=\"A St.\" once=\"A &amp; B\" twice=\"&amp;lt;&amp;amp;&amp;gt; &amp;x;\"/>");
+    CXMLReader Reader(InStream);
+    SXMLEntity Entity;
+
+    EXPECT_TRUE(Reader.ReadEntity(Entity));
+    EXPECT_EQ(Entity.DAttributes.size(), 3);
+    EXPECT_EQ(Entity.AttributeValue("plain"), "A St.");
+    EXPECT_EQ(Entity.AttributeValue("once"), "A & B");
+    EXPECT_EQ(Entity.AttributeValue("twice"), "<&> &x;");
+}
+
+TEST(XMLReaderTest, ManyAttributesTest){
+    // OSM-like document, almost every element is attributes only
+    const int NodeCount = 20000;
+    std::string Document = "<osm>";
+    for(int Index = 0; Index < NodeCount; Index++){
+        Document += "<node id=\"" + std::to_string(Index) + "\" lat=\"38.5178523\" lon=\"-121.7712408\"><tag k=\"name\" v=\"A &amp; B St.\"/></node>";
+    }
+    Document += "</osm>";
+    CXMLReader Reader(std::make_shared<CStringDataSource>(Document));
+    SXMLEntity Entity;
+    int Nodes = 0, Tags = 0;
+    while(Reader.ReadEntity(Entity, true)){
+        if(Entity.DType == SXMLEntity::EType::StartElement){
+            if(Entity.DNameData == "node"){
+                // Attributes of every element keep their document order and values
+                ASSERT_EQ(Entity.DAttributes.size(), 3);
+                EXPECT_EQ(Entity.DAttributes[0], std::make_pair(std::string("id"), std::to_string(Nodes)));
+                EXPECT_EQ(Entity.AttributeValue("lat"), "38.5178523");
+                EXPECT_EQ(Entity.AttributeValue("lon"), "-121.7712408");
+                Nodes++;
+            }
+            else if(Entity.DNameData == "tag" && Entity.AttributeValue("v") == "A & B St."){
+                Tags++;
+            }
+        }
+    }
+    EXPECT_EQ(Nodes, NodeCount);
+    EXPECT_EQ(Tags, NodeCount);
+}
+
+TEST(XMLReaderTest, StreamingTest){
+    // Entities are handed out as the source is parsed, not after the whole document is read
+    std::string Document = "<osm>";
+    for(int Index = 0; Index < 10000; Index++){
+        Document += "<node id=\"" + std::to_string(Index) + "\"/>";
+    }
+    std::string Text(40000,'x');
+    Document += "<note>" + Text + "</note></osm>";
+    auto InStream = std::make_shared<CStringDataSource>(Document);
+    CXMLReader Reader(InStream);
+    SXMLEntity Entity;
+
+    EXPECT_TRUE(Reader.ReadEntity(Entity));
+    EXPECT_EQ(Entity.DNameData, "osm");
+    EXPECT_TRUE(Reader.ReadEntity(Entity));
+    EXPECT_EQ(Entity.AttributeValue("id"), "0");
+    EXPECT_FALSE(InStream->End());
+    EXPECT_FALSE(Reader.End());
+    for(int Index = 1; Index < 10000; Index++){
+        EXPECT_TRUE(Reader.ReadEntity(Entity));
+        EXPECT_TRUE(Reader.ReadEntity(Entity));
+        EXPECT_EQ(Entity.DType, SXMLEntity::EType::StartElement);
+        EXPECT_EQ(Entity.AttributeValue("id"), std::to_string(Index));
+    }
+    EXPECT_TRUE(Reader.ReadEntity(Entity));
+    EXPECT_EQ(Entity.DType, SXMLEntity::EType::EndElement);
+    EXPECT_TRUE(Reader.ReadEntity(Entity));
+    EXPECT_EQ(Entity.DNameData, "note");
+    // Text that spans several reads still comes back as one entity
+    EXPECT_TRUE(Reader.ReadEntity(Entity));
+    EXPECT_EQ(Entity.DType, SXMLEntity::EType::CharData);
+    EXPECT_EQ(Entity.DNameData, Text);
+    EXPECT_TRUE(Reader.ReadEntity(Entity));
+    EXPECT_EQ(Entity.DNameData, "note");
+    EXPECT_TRUE(Reader.ReadEntity(Entity));
+    EXPECT_EQ(Entity.DNameData, "osm");
+    EXPECT_FALSE(Reader.ReadEntity(Entity));
+    EXPECT_TRUE(Reader.End());
+}
 
 TEST(XMLWriterTest, SimpleTest){
     auto OutStream = std::make_shared<CStringDataSink>();